@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Generates the codepoint width table used by widget_uc_sanitize().
+
+The widths follow the same rules as glibc's wcwidth() after being passed
+through the sanitizing rules of widget_uc_sanitize(), so each codepoint is
+classified as one of:
+
+  0 - Zero width (combining marks, format characters, ...), replaced by
+      U+FFFD when printed.
+  1 - Single column, also used for non-printable codepoints as they are
+      passed through unchanged.
+  2 - Double column (East Asian Wide and Fullwidth).
+
+Usage: tools/gen_width_table.py > table.txt, then replace the table in
+widgets.h with the output.
+"""
+
+import sys
+import unicodedata
+
+MAX = 0x110000
+BLOCK_SHIFT = 8
+BLOCK = 1 << BLOCK_SHIFT
+PER_BYTE = 4  # 2 bits per codepoint.
+
+
+# Prepended concatenation marks are format characters that are still printed.
+PREPENDED = (0x0600, 0x0601, 0x0602, 0x0603, 0x0604, 0x0605, 0x06DD, 0x070F,
+             0x0890, 0x0891, 0x08E2, 0x110BD, 0x110CD)
+
+
+def width(uc):
+    ch = chr(uc)
+    cat = unicodedata.category(ch)
+
+    if uc in (0, 0x0A):
+        return 0
+    if cat in ("Cc", "Cs", "Co", "Cn") or uc == 0x00AD or uc in PREPENDED:
+        return 1
+    if cat in ("Mn", "Me", "Cf") or uc == 0x200B:
+        return 0
+    if 0x1160 <= uc <= 0x11FF or 0xD7B0 <= uc <= 0xD7FF:  # Hangul jamo.
+        return 0
+    if 0x3248 <= uc <= 0x324F or 0x4DC0 <= uc <= 0x4DFF:
+        return 2
+    if unicodedata.east_asian_width(ch) in ("W", "F"):
+        return 2
+    return 1
+
+
+def main():
+    widths = [width(uc) for uc in range(MAX)]
+    blocks = []
+    stage1 = []
+
+    for start in range(0, MAX, BLOCK):
+        packed = bytearray(BLOCK // PER_BYTE)
+
+        for i, w in enumerate(widths[start : start + BLOCK]):
+            packed[i // PER_BYTE] |= w << ((i % PER_BYTE) * 2)
+
+        packed = bytes(packed)
+
+        if packed not in blocks:
+            blocks.append(packed)
+
+        stage1.append(blocks.index(packed))
+
+    assert len(blocks) <= 256
+
+    # Trailing blocks are identical, only store up to the last distinct one.
+    last = len(stage1)
+    while last > 1 and stage1[last - 1] == stage1[last - 2]:
+        last -= 1
+
+    out = sys.stdout
+    out.write("/* clang-format off */\n")
+    out.write("/* Generated by tools/gen_width_table.py from Unicode %s. */\n"
+              % unicodedata.unidata_version)
+    out.write("enum {\n\tWIDTH_BLOCK_SHIFT = %d,\n\tWIDTH_STAGE1_LEN = %d,\n};\n\n"
+              % (BLOCK_SHIFT, last))
+    out.write("static const uint8_t width_stage1[WIDTH_STAGE1_LEN] = {\n")
+    stage1 = stage1[:last]
+    for i in range(0, last, 15):
+        out.write("\t" + ", ".join("%d" % x for x in stage1[i : i + 15]) + ",\n")
+    out.write("};\n\n")
+    out.write("static const uint8_t width_stage2[][%d] = {\n" % (BLOCK // PER_BYTE))
+    for block in blocks:
+        out.write("\t{\n")
+        for i in range(0, len(block), 11):
+            out.write("\t\t" + ", ".join("0x%02x" % x for x in block[i : i + 11])
+                      + ",\n")
+        out.write("\t},\n")
+    out.write("};\n")
+    out.write("/* clang-format on */\n")
+
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], "w") as f:
+            f.write("".join(str(w) for w in widths))
+
+
+if __name__ == "__main__":
+    main()
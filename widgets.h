@@ -1,13 +1,18 @@
 #ifndef WIDGETS_H
 #define WIDGETS_H
+#if defined(WIDGETS_TESTS) || defined(WIDGETS_BENCH)
 #ifdef WIDGETS_TESTS
 #undef NDEBUG
+#endif /* WIDGETS_TESTS */
 #define TB_IMPL
 #define STB_DS_IMPLEMENTATION
+#ifndef WIDGETS_HEADLESS
+#define WIDGETS_HEADLESS
+#endif /* !WIDGETS_HEADLESS */
 #ifndef WIDGETS_IMPL
 #define WIDGETS_IMPL
 #endif /* !WIDGETS_IMPL */
-#endif /* !WIDGETS_TESTS */
+#endif /* WIDGETS_TESTS || WIDGETS_BENCH */
 
 #include "termbox.h"
 
@@ -25,6 +30,73 @@ struct widget_points {
 	int y2; /* y of bottom-right corner. */
 };
 
+/* A cell as submitted to termbox. */
+struct widget_cell {
+	uint32_t ch;
+	uintattr_t fg;
+	uintattr_t bg;
+};
+
+/* Remembers the cells written in the previous frame so that identical cells
+ * aren't submitted to termbox again. While it is used, tb_clear() must not be
+ * called between frames, cells that weren't written in a frame are cleared
+ * by widget_shadow_end() instead. */
+struct widget_shadow {
+	int width;
+	int height;
+	unsigned frame;
+	unsigned *stamps; /* Frame in which each cell was last written. */
+	struct widget_cell *cells;
+	struct widget_points damage; /* Bounding box of the changed cells. */
+};
+
+/* Size of the screen, from termbox or the headless grid. */
+int
+widget_width(void);
+int
+widget_height(void);
+/* Sets a cell, through the shadow of the current frame if there is one. All
+ * widgets draw through this function. */
+void
+widget_set_cell(int x, int y, uint32_t ch, uintattr_t fg, uintattr_t bg);
+int
+widget_shadow_init(struct widget_shadow *shadow);
+void
+widget_shadow_finish(struct widget_shadow *shadow);
+/* Starts a frame, all cells set before widget_shadow_end() are diffed against
+ * the previous frame. */
+void
+widget_shadow_begin(struct widget_shadow *shadow);
+/* Clears cells that were written in the previous frame but not in this one.
+ * damage will be filled with the bounding box of the cells that changed, which
+ * is empty if nothing changed. */
+void
+widget_shadow_end(struct widget_shadow *shadow, struct widget_points *damage);
+#ifdef WIDGETS_HEADLESS
+/* With WIDGETS_HEADLESS, widgets draw into an in-memory grid instead of
+ * termbox so no terminal is needed. Cleared cells are spaces. */
+int
+widget_headless_init(int width, int height);
+void
+widget_headless_finish(void);
+/* Clears the grid, like tb_clear(). */
+void
+widget_headless_clear(void);
+/* Returns NULL if the cell is out of bounds. */
+const struct widget_cell *
+widget_headless_cell(int x, int y);
+void
+widget_headless_cursor(int *x, int *y);
+/* Returns the text inside points, or the whole grid if points is NULL. Each
+ * row ends with a newline and trailing spaces are stripped. Must be freed. */
+char *
+widget_headless_dump(const struct widget_points *points);
+/* Compares the text inside points with a snapshot in the format returned by
+ * widget_headless_dump(). Returns -1 if they match, else the first row that
+ * differs relative to points->y1. */
+int
+widget_headless_compare(const struct widget_points *points, const char *golden);
+#endif /* WIDGETS_HEADLESS */
 uint32_t
 widget_uc_sanitize(uint32_t uc, int *width);
 int
@@ -51,6 +123,31 @@ widget_print_str(
 int
 widget_pad_center(int part, int total);
 
+/* A string that is decoded, sanitized and measured once so that it can be
+ * printed repeatedly without doing any of that again. */
+struct widget_text {
+	size_t len;		  /* Number of codepoints. */
+	size_t printable; /* Codepoints before the first forced break. */
+	uint32_t *uc;	  /* Sanitized codepoints. */
+	int *columns;	  /* Width of the first i codepoints at index i, so the
+					   * width of a codepoint is columns[i + 1] - columns[i]. */
+};
+
+int
+widget_text_init(struct widget_text *text, const char *str);
+void
+widget_text_finish(struct widget_text *text);
+/* Same as widget_str_width() on the original string. */
+int
+widget_text_width(const struct widget_text *text);
+/* Returns the number of codepoints that can be printed in max_width columns. */
+size_t
+widget_text_fit(const struct widget_text *text, int max_width);
+/* Same as widget_print_str() on the original string. */
+int
+widget_text_print(const struct widget_text *text, int x, int y, int max_x,
+  uintattr_t fg, uintattr_t bg);
+
 /* Border */
 void
 border_redraw(struct widget_points *points, uintattr_t fg, uintattr_t bg);
@@ -64,38 +161,163 @@ enum input_event {
 	INPUT_RIGHT_WORD,
 	INPUT_LEFT,
 	INPUT_LEFT_WORD,
-	INPUT_ADD /* Must pass an uint32_t argument. */
+	/* Moves between the wrapped rows of the last redraw, keeping the column of
+	 * the cursor where possible. In scroll_horizontal mode HOME and END move to
+	 * the start and end of the text. */
+	INPUT_UP,
+	INPUT_DOWN,
+	INPUT_HOME, /* Start of the row. */
+	INPUT_END,	/* End of the row. */
+	INPUT_PAGE_UP,
+	INPUT_PAGE_DOWN,
+	INPUT_UNDO,
+	INPUT_REDO,
+	INPUT_HISTORY_PUSH, /* Add the text to the history, e.g. when it's sent. */
+	/* Recall older and newer entries in place of the text, going past the
+	 * newest one clears it. Recalls can be undone. */
+	INPUT_HISTORY_PREV,
+	INPUT_HISTORY_NEXT,
+	/* Recall the newest entry older than the recalled one that starts with the
+	 * text before the cursor, the cursor is kept so that searching again finds
+	 * the next match. The entries with the prefix are found with a binary
+	 * search but then all scanned for the newest one, so a search is
+	 * O(log n + k) for k of them. Without a prefix it's a step back. */
+	INPUT_HISTORY_SEARCH,
+	INPUT_ADD, /* Must pass an uint32_t argument. */
+	/* Insert many codepoints at once, e.g. for pastes. Text past the size limit
+	 * is dropped. */
+	INPUT_ADD_STR,	 /* Must pass a UTF-8 const char * and a size_t length. */
+	INPUT_ADD_UTF32, /* Must pass a const uint32_t * and a size_t length. */
+};
+
+/* Where a wrapped line of the input starts. */
+struct input_line {
+	size_t start; /* Index of the first codepoint that can be on the line. */
+	bool checked; /* Whether the line was started by wrapping start itself. */
+};
+
+/* An edit that can be undone. */
+struct input_edit {
+	bool insert;   /* Whether text was inserted instead of erased. */
+	bool reversed; /* Whether the text is stored backwards. */
+	bool chain;	   /* Whether it's undone together with the previous edit. */
+	size_t pos;	   /* Index of the text in the input. */
+	size_t len;
+	size_t offset; /* Offset of the text in the journal, wrapping around. */
+};
+
+/* Undo history. Edits only store the text they inserted or erased, which is
+ * kept in a ring of max codepoints that drops the oldest edits once full. */
+struct input_journal {
+	bool merge;	   /* Whether the next keystroke can join the last edit. */
+	bool applying; /* Set while edits are undone or redone. */
+	bool chain;	   /* Whether the next edit is chained to the last one. */
+	size_t max;	   /* Codepoints kept at most, 0 disables undo. */
+	size_t ring;   /* The max text is laid out for. */
+	size_t first;  /* Index of the oldest edit. */
+	size_t pos;	   /* Index of the next edit to redo. */
+	size_t end;	   /* Offset of the next codepoint in text. */
+	struct input_edit *edits;
+	uint32_t *text;
+};
+
+struct input_history_entry {
+	size_t offset; /* Offset of the text in the history. */
+	size_t len;
+};
+
+/* Sent texts, kept one after the other in a ring of max codepoints that drops
+ * the oldest entries once full. Entries are identified by the number of entries
+ * added before them. */
+struct input_history {
+	size_t max;	  /* Codepoints kept at most, 0 disables the history. */
+	size_t ring;  /* The max text is laid out for. */
+	size_t base;  /* Id of entries[0]. */
+	size_t first; /* Index of the oldest entry. */
+	size_t pos;	  /* Id of the recalled entry, the next id if there is none. */
+	size_t end;	  /* Offset of the next entry in text. */
+	struct input_history_entry *entries;
+	size_t *sorted; /* Ids of the entries sorted by their text. */
+	uint32_t *text;
 };
 
 struct input {
 	bool scroll_horizontal;
 	int start_y;
+	int rows;  /* Rows taken in the last redraw. */
+	int cur_x; /* Cursor position in the last redraw. */
+	int cur_y;
+	int goal_x; /* Column kept across vertical moves, -1 if there is none. */
 	uintattr_t bg;
-	size_t cur_buf; /* Current position inside buf. */
-	uint32_t *buf;	/* We use a basic array instead of something like a linked
-					 * list of small arrays  or a gap buffer as pretty much all
-					 * messages are small enough that array
-					 * insertion / deletion performance isn't an issue. */
+	struct widget_points points; /* Points passed to the last redraw. */
+	size_t cur_buf; /* Current position inside the text. */
+	size_t max_len; /* Maximum number of codepoints, 0 for no limit. */
+	/* A gap buffer, the text is stored around a gap of unused space which is
+	 * moved to the cursor on edits so that typing and deleting are O(1)
+	 * amortized even with large pasted texts. */
+	size_t gap;		/* Start of the gap in buf. */
+	size_t gap_len; /* Length of the gap in buf. */
+	uint32_t *buf;
+	size_t utf8_len; /* Length of the text in UTF-8. */
+	/* Starts of the wrapped lines, laid out lazily up to the rows needed for
+	 * drawing and dropped from the position of each edit onwards. */
+	struct input_line *layout;
+	int layout_width; /* Width of the points the lines were laid out for. */
+	bool layout_done; /* Whether the last line in layout is the last one. */
+	/* Visible part of the text in scroll_horizontal mode, the codepoints from
+	 * view_start to view_end take view_width columns. It's moved along with the
+	 * cursor instead of being searched for from the start on every redraw. */
+	bool view_valid;
+	int view_width;
+	size_t view_start;
+	size_t view_end;
+	struct input_journal journal;
+	struct input_history history;
 };
 
+/* max_len is set to 2000, journal.max and history.max to 65536 by default. */
 int
 input_init(struct input *input, uintattr_t bg, bool scroll_horizontal);
 void
 input_finish(struct input *input);
+/* Number of codepoints in the input. */
+size_t
+input_len(const struct input *input);
 /* rows will be filled with the number of rows taken by the input field. */
 void
 input_redraw(
   struct input *input, struct widget_points *points, int *rows, bool dry_run);
 enum widget_error
 input_handle_event(struct input *input, enum input_event event, ...);
+/* Same as input_handle_event() but also fills damage with the part of the
+ * points passed to the last redraw that has to be redrawn. It is empty if the
+ * input wasn't drawn yet. */
+enum widget_error
+input_handle_event_damage(struct input *input, struct widget_points *damage,
+  enum input_event event, ...);
 char *
 input_buf(struct input *input);
+/* Writes the text into dst as a NUL terminated UTF-8 string, truncated at a
+ * codepoint boundary if size is too small. Returns the length of the whole text
+ * in bytes without the NUL, so a size of 0 can be passed to get it. */
+size_t
+input_buf_into(const struct input *input, char *dst, size_t size);
 
 /* Treeview. */
 
+struct treeview;
+struct treeview_node;
+
 /* Called to draw the data. */
 typedef void (*treeview_draw_cb)(
   void *data, struct widget_points *points, bool is_selected);
+/* Called to add the children of node, see treeview_node.populate_cb. */
+typedef void (*treeview_populate_cb)(
+  struct treeview *treeview, struct treeview_node *node);
+/* Returns less than, equal to or greater than 0 if a sorts before, the same as
+ * or after b, see treeview_node.compare_cb. */
+typedef int (*treeview_compare_cb)(
+  const struct treeview_node *a, const struct treeview_node *b);
 
 enum treeview_event {
 	TREEVIEW_EXPAND = 0,
@@ -106,27 +328,89 @@ enum treeview_event {
 	 * passed node should be freed to avoid leaks. */
 	TREEVIEW_INSERT,		/* Add a child node to the selected node. */
 	TREEVIEW_INSERT_PARENT, /* Add a node to the selected node's parent. */
-	/* Jump to a node, pass a pointer to a treeview struct parent->nodes[index]
-	 */
+	/* Jump to a node, pass a pointer to a treeview_node struct. */
 	TREEVIEW_JUMP,
 	TREEVIEW_DELETE, /* Delete the selected node along with it's children. The
 						root node cannot be deleted. */
+	/* Move the selected node along with it's children under the passed
+	 * treeview_node struct pointer, or to the top level if it's NULL. */
+	TREEVIEW_MOVE,
 };
 
 struct treeview_node {
 	bool is_expanded; /* Whether it's children are visible. */
-	size_t index;	  /* Index in the nodes array. */
+	size_t index;	  /* Index in the parent's nodes array. */
+	/* Rows taken by the children when expanded, kept up to date along the
+	 * parents on every change so is_expanded must only be toggled through
+	 * TREEVIEW_EXPAND once the node has children. */
+	size_t visible;
+	/* Rows taken by the previous siblings, computed lazily. It's only valid if
+	 * index is below the parent's offsets_valid. */
+	size_t offset;
+	size_t offsets_valid; /* Number of children with a valid offset. */
 	struct treeview_node *parent;
 	struct treeview_node **nodes;
 	void *data; /* Any user data. */
 	treeview_draw_cb draw_cb;
+	/* If set, the node should start collapsed and it's children are only
+	 * added by this the first time it's expanded. */
+	treeview_populate_cb populate_cb;
+	/* If set, children are inserted at their position in the order of this
+	 * instead of at the end. Children added without one inherit it, so setting
+	 * it on the treeview's root before adding nodes sorts the whole tree. */
+	treeview_compare_cb compare_cb;
+	bool is_populated; /* Whether populate_cb was called. */
+	bool is_matched;   /* Whether the key matches the filter. */
+	/* Whether it's hidden by the filter, in which case it takes no rows. */
+	bool is_hidden;
+	struct treeview_pool *pool; /* Pool of the node, NULL if allocated alone. */
+	/* Text matched by treeview_filter(), nodes without one never match. */
+	const char *key;
+	/* Children with matches in their subtree, plus one if it matches. */
+	size_t matched;
+};
+
+/* Nodes allocated in slabs, which are freed all at once with the treeview. */
+struct treeview_pool {
+	struct treeview_node **slabs;
+	size_t used;				 /* Nodes taken from the last slab. */
+	struct treeview_node *free; /* Destroyed nodes, linked through parent. */
+};
+
+/* A node for treeview_build(). */
+struct treeview_record {
+	size_t depth; /* 0 for the children of the node being built into. */
+	void *data;
+	treeview_draw_cb draw_cb;
+	const char *key; /* See treeview_node.key. */
+};
+
+/* A child of parent, one per level on the path to a node. */
+struct treeview_walk {
+	struct treeview_node *parent;
+	size_t index;
+};
+
+/* State of treeview_filter(). Each level holds the matches of the query cut
+ * at base plus the level's index, so that they can be reused when the query
+ * grows or shrinks back. */
+struct treeview_filter {
+	char *query; /* Current query, empty if there's no filter. */
+	struct treeview_node **matches; /* Matches of every level one after the
+									   other. */
+	size_t *ends;					/* End of each level in matches. */
+	size_t base;
 };
 
 struct treeview {
-	int skipped; /* A hack used to skip lines in recursive rendering. */
 	int start_y;
+	struct widget_points points; /* Points passed to the last redraw. */
 	struct treeview_node root;
 	struct treeview_node *selected;
+	/* Path to the node being drawn, kept to avoid allocating on redraws. */
+	struct treeview_walk *walk;
+	struct treeview_pool pool;
+	struct treeview_filter filter;
 };
 
 struct treeview_node *
@@ -134,6 +418,11 @@ treeview_node_alloc(void *data, treeview_draw_cb draw_cb);
 int
 treeview_node_init(
   struct treeview_node *node, void *data, treeview_draw_cb draw_cb);
+/* Same as treeview_node_alloc() but the node is taken from the treeview's pool.
+ * The treeview must not be moved after this as nodes point to it's pool. */
+struct treeview_node *
+treeview_pool_alloc(
+  struct treeview *treeview, void *data, treeview_draw_cb draw_cb);
 void
 treeview_node_destroy(struct treeview_node *node);
 void
@@ -141,6 +430,43 @@ treeview_node_finish(struct treeview_node *node);
 int
 treeview_node_add_child(
   struct treeview_node *parent, struct treeview_node *child);
+/* Moves node along with it's children under parent, or to the top level if it's
+ * NULL, without copying or freeing any of them. Only the parents of both
+ * positions are updated, the selection stays on it's node unless it ends up
+ * collapsed or hidden. Returns -1 if node isn't in a tree or parent is in the
+ * subtree of node. */
+int
+treeview_node_reparent(struct treeview *treeview, struct treeview_node *node,
+  struct treeview_node *parent);
+/* Returns the first child of a parent with a compare_cb which compares equal to
+ * node, which is only passed to compare_cb, or NULL if there's none. */
+struct treeview_node *
+treeview_node_find(
+  const struct treeview_node *parent, const struct treeview_node *node);
+/* Frees the children of a collapsed node with a populate_cb so that they are
+ * added again the next time it's expanded. Returns -1 if the node is expanded,
+ * has no populate_cb or the selected node is one of it's children. */
+int
+treeview_node_evict(struct treeview *treeview, struct treeview_node *node);
+/* Adds the nodes of records, which are in pre-order, to parent or the root if
+ * it's NULL. The nodes are allocated from the pool in one pass with their
+ * nodes arrays sized exactly and the first row is selected if there was no
+ * selection. Children of nodes with a compare_cb are sorted once they are all
+ * added, which is only a pass over them if the records are in order. Returns
+ * -1 if a record has no draw_cb or is more than one level below the previous
+ * one, in which case nothing is added, or if allocating fails, which keeps the
+ * nodes added until then. */
+int
+treeview_build(struct treeview *treeview, struct treeview_node *parent,
+  const struct treeview_record *records, size_t len);
+/* Shows only the nodes whose key contains query, ignoring ASCII case, along
+ * with their parents. NULL or an empty query shows every node again. A query
+ * extending or cutting the previous one only tests the nodes that matched
+ * before, so nodes added since are shown until it's set again from scratch,
+ * which setting the same query does. A hidden selection moves to it's closest
+ * shown parent or the first row. Returns -1 if the treeview is NULL. */
+int
+treeview_filter(struct treeview *treeview, const char *query);
 int
 treeview_init(struct treeview *treeview);
 void
@@ -149,20 +475,60 @@ void
 treeview_redraw(struct treeview *treeview, struct widget_points *points);
 enum widget_error
 treeview_event(struct treeview *treeview, enum treeview_event event, ...);
+/* Same as treeview_event() but also fills damage with the part of the points
+ * passed to the last redraw that has to be redrawn. It is empty if the
+ * treeview wasn't drawn yet. */
+enum widget_error
+treeview_event_damage(struct treeview *treeview, struct widget_points *damage,
+  enum treeview_event event, ...);
 
 #endif /* !WIDGETS_H */
 
 #ifdef WIDGETS_IMPL
+#ifdef WIDGETS_BENCH
+#include <stdlib.h>
+
+/* Count every allocation made by the widgets and stb_ds. */
+static size_t bench_allocs = 0;
+
+static void *
+bench_realloc(void *ptr, size_t size) {
+	bench_allocs++;
+	return realloc(ptr, size);
+}
+
+#define STBDS_REALLOC(context, ptr, size) bench_realloc(ptr, size)
+#define STBDS_FREE(context, ptr) free(ptr)
+#define WIDGETS_MALLOC(size) bench_realloc(NULL, size)
+#define WIDGETS_FREE(ptr) free(ptr)
+#endif /* WIDGETS_BENCH */
+
+/* The allocator can be overridden by defining both of these before including
+ * the implementation. Strings returned by input_buf() must then be freed with
+ * WIDGETS_FREE. */
+#ifndef WIDGETS_MALLOC
+#define WIDGETS_MALLOC(size) malloc(size)
+#define WIDGETS_FREE(ptr) free(ptr)
+#endif /* !WIDGETS_MALLOC */
+
 #include "stb_ds.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <wchar.h>
 #include <wctype.h>
 
+#if defined(__GNUC__) && defined(__AVX2__)
+#include <immintrin.h>
+#define WIDGETS_ASCII_AVX2
+#elif defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define WIDGETS_ASCII_SSE2
+#endif
+
 static int
 min(int x, int y) {
 	return x < y ? x : y;
@@ -173,10 +539,1162 @@ max(int x, int y) {
 	return x > y ? x : y;
 }
 
+static size_t
+min_size(size_t x, size_t y) {
+	return x < y ? x : y;
+}
+
+static size_t
+max_size(size_t x, size_t y) {
+	return x > y ? x : y;
+}
+
+/* clang-format off */
+/* Generated by tools/gen_width_table.py from Unicode 14.0.0. */
+enum {
+	WIDTH_BLOCK_SHIFT = 8,
+	WIDTH_STAGE1_LEN = 3587,
+};
+
+static const uint8_t width_stage1[WIDTH_STAGE1_LEN] = {
+	0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+	14, 15, 16, 1, 17, 1, 1, 1, 18, 19, 20, 21, 22, 23, 24,
+	1, 1, 25, 1, 1, 26, 1, 27, 28, 29, 1, 1, 1, 30, 31,
+	32, 33, 34, 35, 36, 37, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 39,
+	1, 40, 1, 41, 42, 43, 44, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 45, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 38, 46, 47, 1, 1, 48,
+	49, 1, 50, 51, 52, 1, 1, 1, 1, 1, 1, 53, 1, 1, 54,
+	55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 1, 68,
+	69, 70, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 71, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 72, 73, 1, 1, 1, 74, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 75, 38, 38, 38, 38, 76, 77, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 78, 38, 79, 80,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 81, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 82, 1,
+	83, 84, 1, 1, 1, 1, 1, 1, 1, 85, 1, 1, 1, 1, 1,
+	86, 73, 87, 1, 1, 1, 1, 1, 88, 89, 1, 1, 1, 1, 1,
+	1, 90, 91, 92, 93, 94, 95, 96, 97, 1, 98, 99, 1, 1, 1,
+	1, 1, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 100, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 101, 102, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 103, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 104, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 38, 38, 105, 1, 1,
+	1, 1, 1, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+	38, 38, 38, 38, 38, 38, 38, 106, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 107,
+	108, 1,
+};
+
+static const uint8_t width_stage2[][64] = {
+	{
+		0x54, 0x55, 0x45, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15,
+		0x00, 0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x10, 0x41, 0x10, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x40, 0x54, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x54, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00,
+		0x14, 0x00, 0x14, 0x04, 0x50, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x00,
+		0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x55, 0x55, 0x51,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x10, 0x00, 0x00, 0x01, 0x01,
+		0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x01, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{
+		0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x45, 0x54, 0x01, 0x00, 0x54, 0x51, 0x01, 0x00,
+		0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x51,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x54, 0x01, 0x54, 0x55, 0x51, 0x55, 0x55, 0x55,
+		0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45,
+	},
+	{
+		0x41, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x54, 0x41, 0x15, 0x14, 0x50, 0x51, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x51, 0x55, 0x55, 0x41,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x54, 0x01, 0x10, 0x54, 0x51, 0x55, 0x55, 0x55,
+		0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00,
+	},
+	{
+		0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x14, 0x01, 0x54, 0x55, 0x51, 0x55, 0x41,
+		0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x54, 0x55, 0x55, 0x51, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x54, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x04, 0x54, 0x05, 0x04, 0x50, 0x55, 0x41,
+		0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x51,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x14, 0x55, 0x45, 0x55, 0x50, 0x55, 0x55, 0x55,
+		0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x15, 0x54, 0x01, 0x54, 0x55, 0x51, 0x55, 0x55,
+		0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x51,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45, 0x55, 0x05, 0x44, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x51, 0x00, 0x40, 0x55, 0x55, 0x15, 0x00, 0x40, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x51, 0x00, 0x00, 0x54, 0x55, 0x55, 0x00, 0x50, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x11, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x01, 0x00, 0x00, 0x40, 0x00,
+		0x04, 0x55, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x54, 0x55, 0x45, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x01, 0x04, 0x00, 0x41, 0x41, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x50, 0x05, 0x54, 0x55, 0x55, 0x55, 0x01, 0x54, 0x55, 0x55, 0x45,
+		0x41, 0x55, 0x51, 0x55, 0x55, 0x55, 0x51, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x01, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x05, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x10, 0x00, 0x50, 0x55, 0x45, 0x01, 0x00, 0x00, 0x55, 0x55,
+		0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x15, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x41, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x51, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x40, 0x15, 0x54,
+		0x55, 0x45, 0x55, 0x01, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x14, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45,
+		0x00, 0x40, 0x44, 0x01, 0x00, 0x54, 0x15, 0x00, 0x00, 0x14, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x04, 0x40, 0x54, 0x45, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x55, 0x55, 0x55, 0x50,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x50, 0x10, 0x50,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x45, 0x50, 0x11, 0x50, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x00, 0x00, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x40, 0x00, 0x00,
+		0x00, 0x04, 0x00, 0x54, 0x51, 0x55, 0x54, 0x50, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{
+		0x55, 0x55, 0x15, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05,
+		0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x00, 0x04, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0x55, 0x55, 0x69,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0xa9, 0x56, 0x96, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x69,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x55,
+		0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x59, 0x55, 0xa5, 0x55,
+		0x55, 0x55, 0x55, 0x69, 0x55, 0x5a, 0x55, 0x65, 0x55, 0x56, 0x55,
+		0x55, 0x55, 0x55, 0x65, 0x55, 0xa5, 0x59, 0x65, 0x59,
+	},
+	{
+		0x55, 0x59, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x56,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x66, 0x95, 0x9a,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0xa9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x56, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x56, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x56, 0x59,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x15, 0x50, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x9a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x0a,
+		0xa0, 0xaa, 0xaa, 0xaa, 0x6a, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0x81, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0x55, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0x56, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x40, 0x00, 0x00, 0x50, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x55, 0x55,
+	},
+	{
+		0x45, 0x45, 0x15, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x41, 0x55,
+		0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x00, 0x00, 0x00, 0x00, 0x50, 0x55, 0x55, 0x15,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00,
+		0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x50, 0x55,
+		0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x56, 0x40,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x15, 0x05, 0x50, 0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x01,
+		0x40, 0x41, 0x41, 0x55, 0x55, 0x15, 0x55, 0x55, 0x54, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x54, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x04, 0x14, 0x54, 0x05, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x45, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x51, 0x54, 0x51, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x15, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x00, 0x00, 0x00, 0x00, 0xaa, 0xaa, 0x5a, 0x55, 0x00, 0x00, 0x00,
+		0x00, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0xaa,
+		0xaa, 0xaa, 0xaa, 0x6a, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15,
+	},
+	{
+		0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0xaa, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x01, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x51,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x40, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x01, 0x41, 0x55, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x40, 0x15, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x41, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x54,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x00, 0x54, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05,
+		0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x00, 0x00, 0x00, 0x40, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x14, 0x54, 0x55, 0x15, 0x50,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x15, 0x40, 0x41, 0x55, 0x45, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00,
+		0x01, 0x00, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x55, 0x55, 0x55, 0x50,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x05, 0x00, 0x40, 0x55, 0x55, 0x01, 0x14, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x15, 0x50, 0x04, 0x55, 0x45, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x15, 0x15, 0x00, 0x40, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x15, 0x54, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x05, 0x00, 0x54, 0x00, 0x54, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x00, 0x00, 0x05, 0x44, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x45, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x15, 0x00, 0x44, 0x15, 0x04, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x05, 0x50, 0x55, 0x10, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x15, 0x00, 0x40, 0x11, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x51,
+		0x00, 0x10, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x01, 0x05, 0x10, 0x00,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x15, 0x00, 0x00, 0x41, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x15, 0x44, 0x15, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x05,
+		0x55, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x01, 0x00, 0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x15, 0x00, 0x14, 0x40, 0x55, 0x15, 0x55, 0x55, 0x01, 0x40,
+		0x01, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x05, 0x00, 0x00, 0x40, 0x50, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x00, 0x40, 0x00, 0x10, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00,
+		0x04, 0x41, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x01, 0x40, 0x45, 0x10, 0x00, 0x10, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x50, 0x11, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x54, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x00, 0x00, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x54, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x00, 0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x15, 0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0xaa, 0x54, 0x55, 0x55, 0x5a, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xa9, 0xaa, 0x69,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x6a, 0x55,
+		0x55, 0x55, 0x55, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x41, 0x00, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x15, 0x50, 0x55, 0x15, 0x00, 0x00, 0x00, 0x40,
+		0x01, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x50,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x54, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x40, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x55, 0x51, 0x55, 0x55, 0x55,
+		0x54, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x01, 0x00, 0x00, 0x00,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x10, 0x04, 0x40,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x00, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x40, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x40, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x65, 0xa9, 0xaa, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x6a, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0xaa, 0xaa, 0x56, 0x55, 0x5a, 0x55,
+		0x55, 0x55, 0xaa, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x56, 0x55, 0x55,
+		0xa9, 0xaa, 0x9a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa6, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0x95, 0xaa, 0x55, 0x55,
+		0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0x56, 0x56, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0xa6, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x96,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55, 0x55, 0x95, 0x6a, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x69, 0x55, 0x55, 0x55, 0x56, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55, 0x56, 0x6a, 0xa9, 0x55,
+		0xa9, 0x55, 0x55, 0x95, 0x56, 0x55, 0xaa, 0xaa, 0x56,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0xaa, 0xaa, 0xaa, 0x55, 0x56, 0x55, 0x55, 0x55,
+	},
+	{
+		0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0x6a, 0xaa, 0xaa, 0x9a, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x56, 0xaa, 0x56, 0xaa,
+		0x6a, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x56,
+		0xaa, 0xaa, 0x6a, 0x55, 0xaa, 0x5a, 0x55, 0x55, 0xaa, 0xaa, 0x5a,
+		0x55, 0xaa, 0xaa, 0x55, 0x55, 0xaa, 0x6a, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0x56, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55, 0x55, 0x55,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+		0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+		0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	},
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55,
+	},
+};
+/* clang-format on */
+
+/* Returns the width of a codepoint as given by wcwidth() in an UTF-8 locale,
+ * except that zero width codepoints return 0 and non-printable ones return 1.
+ * Doesn't depend on the current locale. */
+static int
+uc_width(uint32_t uc) {
+	/* Everything below the combining diacritical marks is a single column
+	 * except NUL. */
+	if (uc < 0x300) {
+		return uc != 0;
+	}
+
+	size_t block = min((int) (uc >> WIDTH_BLOCK_SHIFT), WIDTH_STAGE1_LEN - 1);
+	uint32_t offset = uc & ((1U << WIDTH_BLOCK_SHIFT) - 1);
+	uint8_t packed = width_stage2[width_stage1[block]][offset / 4];
+
+	return (packed >> ((offset % 4) * 2)) & 3;
+}
+
 uint32_t
 widget_uc_sanitize(uint32_t uc, int *width) {
-	int tmp_width = wcwidth((wchar_t) uc);
-
 	switch (uc) {
 	case '\n':
 		*width = 0;
@@ -185,27 +1703,102 @@ widget_uc_sanitize(uint32_t uc, int *width) {
 		*width = 1;
 		return ' ';
 	default:
-		if (tmp_width < 0) {
-			*width = 1;
-			return uc;
-		}
+		*width = uc_width(uc);
 
-		if (tmp_width == 0 || tmp_width > WIDGET_CH_MAX) {
-			*width = wcwidth(L'�');
+		if (*width == 0) {
+			*width = uc_width(L'�');
 			return L'�';
 		}
 
-		*width = tmp_width;
 		return uc;
 	}
 }
 
+static bool
+is_print_ascii(char ch) {
+	return ch >= ' ' && ch <= '~';
+}
+
+/* Returns the number of printable ASCII characters at the start of str, which
+ * are always a single column wide and don't need to be sanitized.
+ *
+ * The vectorized versions use aligned loads so they may read past the NUL
+ * terminator but never into the next page, hence the sanitizer is disabled. */
+#if defined(WIDGETS_ASCII_AVX2) || defined(WIDGETS_ASCII_SSE2)
+__attribute__((no_sanitize_address)) static size_t
+ascii_run(const char *str) {
+#ifdef WIDGETS_ASCII_AVX2
+	typedef __m256i vec_t;
+	const unsigned all = 0xFFFFFFFFU;
+#define vec_set1 _mm256_set1_epi8
+#define vec_load(p) _mm256_load_si256((const vec_t *) (p))
+#define vec_and _mm256_and_si256
+#define vec_gt _mm256_cmpgt_epi8
+#define vec_mask _mm256_movemask_epi8
+#else
+	typedef __m128i vec_t;
+	const unsigned all = 0xFFFFU;
+#define vec_set1 _mm_set1_epi8
+#define vec_load(p) _mm_load_si128((const vec_t *) (p))
+#define vec_and _mm_and_si128
+#define vec_gt _mm_cmpgt_epi8
+#define vec_mask _mm_movemask_epi8
+#endif
+	const char *ptr = str;
+
+	for (; ((uintptr_t) ptr % sizeof(vec_t)) != 0; ptr++) {
+		if (!is_print_ascii(*ptr)) {
+			return (size_t) (ptr - str);
+		}
+	}
+
+	/* Bytes are compared as signed so anything above 0x7F is negative. */
+	const vec_t low = vec_set1(' ' - 1);
+	const vec_t high = vec_set1('~' + 1);
+
+	for (;; ptr += sizeof(vec_t)) {
+		vec_t chunk = vec_load(ptr);
+		unsigned mask = (unsigned) vec_mask(
+		  vec_and(vec_gt(chunk, low), vec_gt(high, chunk)));
+
+		if (mask != all) {
+			return (size_t) (ptr - str) + (size_t) __builtin_ctz(~mask);
+		}
+	}
+#undef vec_set1
+#undef vec_load
+#undef vec_and
+#undef vec_gt
+#undef vec_mask
+}
+#else
+static size_t
+ascii_run(const char *str) {
+	size_t len = 0;
+
+	while (is_print_ascii(str[len])) {
+		len++;
+	}
+
+	return len;
+}
+#endif
+
 int
 widget_str_width(const char *str) {
 	int width = 0;
 
 	if (str) {
 		for (size_t i = 0; str[i];) {
+			size_t run = ascii_run(&str[i]);
+
+			i += run;
+			width += (int) run;
+
+			if (!str[i]) {
+				break;
+			}
+
 			int ch_width = 0;
 			uint32_t uc = 0;
 
@@ -225,1161 +1818,5049 @@ widget_str_width(const char *str) {
 	return width;
 }
 
-bool
-widget_points_in_bounds(const struct widget_points *points, int x, int y) {
-	return (
-	  x >= points->x1 && x < points->x2 && y >= points->y1 && y < points->y2);
-}
+#ifdef WIDGETS_HEADLESS
+static struct {
+	int width;
+	int height;
+	int cursor_x;
+	int cursor_y;
+	struct widget_cell *cells;
+} headless = {0};
 
-/* Ensure that no point is negative or out of bounds. */
-void
-widget_points_set(
-  struct widget_points *points, int x1, int x2, int y1, int y2) {
-	if (!points) {
-		return;
-	}
+static int
+screen_width(void) {
+	return headless.width;
+}
 
-	int height = tb_height();
-	int width = tb_width();
+static int
+screen_height(void) {
+	return headless.height;
+}
 
-	*points = (struct widget_points) {.x1 = min(max(0, x1), width),
-	  .x2 = min(max(0, x2), width),
-	  .y1 = min(max(0, y1), height),
-	  .y2 = min(max(0, y2), height)};
+static void
+screen_set_cell(int x, int y, uint32_t ch, uintattr_t fg, uintattr_t bg) {
+	if (x >= 0 && x < headless.width && y >= 0 && y < headless.height) {
+		headless.cells[(y * headless.width) + x]
+		  = (struct widget_cell) {.ch = ch, .fg = fg, .bg = bg};
+	}
 }
 
-bool
-widget_should_forcebreak(int width) {
-	return width == 0;
+static void
+screen_set_cursor(int x, int y) {
+	headless.cursor_x = x;
+	headless.cursor_y = y;
 }
 
-bool
-widget_should_scroll(int x, int width, int max_width) {
-	return (x > (max_width - width) || (widget_should_forcebreak(width)));
+static void
+screen_clear(void) {
+	widget_headless_clear();
 }
 
-bool
-widget_advance_xy_if_scroll(
-  int *x, int *y, struct widget_points *points, int width) {
-	if (x && y && points && (widget_should_scroll(*x, width, points->x2))) {
-		*x = points->x1;
-		(*y)++;
+int
+widget_headless_init(int width, int height) {
+	if (width < 0 || height < 0) {
+		return -1;
+	}
 
-		return true;
-	}
+	widget_headless_finish();
 
-	return false;
-}
+	size_t len = (size_t) width * (size_t) height;
 
-int
-widget_print_str(
-  int x, int y, int max_x, uintattr_t fg, uintattr_t bg, const char *str) {
-	if (!str) {
-		return 0;
-	}
+	headless.cells
+	  = len > 0 ? WIDGETS_MALLOC(len * sizeof(*headless.cells)) : NULL;
 
-	uint32_t uc = 0;
-	int width = 0;
-	int original = x;
+	if (len > 0 && !headless.cells) {
+		return -1;
+	}
 
-	while (*str) {
-		int len = tb_utf8_char_to_unicode(&uc, str);
+	headless.width = width;
+	headless.height = height;
+	widget_headless_clear();
 
-		if (len == TB_ERR) {
-			break;
-		}
+	return 0;
+}
 
-		str += len;
-		uc = widget_uc_sanitize(uc, &width);
+void
+widget_headless_finish(void) {
+	WIDGETS_FREE(headless.cells);
+	memset(&headless, 0, sizeof(headless));
+}
 
-		if ((widget_should_scroll(x, width, max_x))) {
-			break;
-		}
+void
+widget_headless_clear(void) {
+	for (int i = 0, len = headless.width * headless.height; i < len; i++) {
+		headless.cells[i]
+		  = (struct widget_cell) {.ch = ' ', .fg = TB_DEFAULT, .bg = TB_DEFAULT};
+	}
 
-		tb_set_cell(x, y, uc, fg, bg);
+	headless.cursor_x = headless.cursor_y = -1;
+}
 
-		x += width;
+const struct widget_cell *
+widget_headless_cell(int x, int y) {
+	if (x < 0 || x >= headless.width || y < 0 || y >= headless.height) {
+		return NULL;
 	}
 
-	return x - original;
+	return &headless.cells[(y * headless.width) + x];
 }
 
-int
-widget_pad_center(int part, int total) {
-	int padding = (int) round(((double) (total - part)) / 2);
-
-	if (padding < 0) {
-		return 0;
+void
+widget_headless_cursor(int *x, int *y) {
+	if (x) {
+		*x = headless.cursor_x;
 	}
 
-	return padding;
+	if (y) {
+		*y = headless.cursor_y;
+	}
 }
 
-enum {
-	BORDER_NORMAL = 0,
-	BORDER_CORNER_LEFT,
-	BORDER_CORNER_RIGHT,
-	BORDER_CORNER_LEFT_BOTTOM,
-	BORDER_CORNER_RIGHT_BOTTOM,
-	BORDER_VERTICAL,
-	BORDER_MAX
-};
-
-static const char *const borders[BORDER_MAX] = {
-  [BORDER_NORMAL] = "─",
-  [BORDER_CORNER_LEFT] = "┌",
-  [BORDER_CORNER_RIGHT] = "┐",
-  [BORDER_CORNER_LEFT_BOTTOM] = "└",
-  [BORDER_CORNER_RIGHT_BOTTOM] = "┘",
-  [BORDER_VERTICAL] = "│",
-};
+char *
+widget_headless_dump(const struct widget_points *points) {
+	struct widget_points all = {0, headless.width, 0, headless.height};
 
-void
-border_redraw(struct widget_points *points, uintattr_t fg, uintattr_t bg) {
 	if (!points) {
-		return;
+		points = &all;
 	}
 
-	int height = points->y2 - points->y1;
+	enum { max_codepoint_len = 6 };
 
-	for (int x = points->x1 + 1; x < (points->x2 - 1); x++) {
-		widget_print_str(
-		  x, points->y1, points->x2, fg, bg, borders[BORDER_NORMAL]);
+	int rows = max(points->y2 - points->y1, 0);
+	int cols = max(points->x2 - points->x1, 0);
+	size_t row_size = ((size_t) cols * max_codepoint_len) + 1;
+	char *dump = WIDGETS_MALLOC(((size_t) rows * row_size) + 1);
+
+	if (!dump) {
+		return NULL;
 	}
 
-	widget_print_str(
-	  points->x1, points->y1, points->x2, fg, bg, borders[BORDER_CORNER_LEFT]);
-	widget_print_str(points->x2 - 1, points->y1, points->x2, fg, bg,
-	  borders[BORDER_CORNER_RIGHT]);
+	size_t len = 0;
 
-	/* Not points->y2 - 1 so that we write borders even if height < 2 */
-	for (int y = points->y1 + 1; y < points->y2; y++) {
-		widget_print_str(
-		  points->x1, y, points->x2, fg, bg, borders[BORDER_VERTICAL]);
-		widget_print_str(
-		  points->x2 - 1, y, points->x2, fg, bg, borders[BORDER_VERTICAL]);
-	}
+	for (int y = points->y1; y < points->y2; y++) {
+		size_t row_len = len; /* Length without trailing spaces. */
 
-	/* Don't overwrite the left/right or top connection. */
-	if (height > 2) {
-		widget_print_str(points->x1, points->y2 - 1, points->x2, fg, bg,
-		  borders[BORDER_CORNER_LEFT_BOTTOM]);
-		widget_print_str(points->x2 - 1, points->y2 - 1, points->x2, fg, bg,
-		  borders[BORDER_CORNER_RIGHT_BOTTOM]);
+		for (int x = points->x1; x < points->x2;) {
+			const struct widget_cell *cell = widget_headless_cell(x, y);
+			int width = 1;
 
-		for (int x = points->x1 + 1; x < (points->x2 - 1); x++) {
-			widget_print_str(
-			  x, points->y2 - 1, points->x2, fg, bg, borders[BORDER_NORMAL]);
+			if (cell) {
+				widget_uc_sanitize(cell->ch, &width);
+				len += (size_t) tb_utf8_unicode_to_char(&dump[len], cell->ch);
+			} else {
+				dump[len++] = ' ';
+			}
+
+			if (!cell || cell->ch != ' ') {
+				row_len = len;
+			}
+
+			/* The next cell is covered by a wide character. */
+			x += max(width, 1);
 		}
+
+		len = row_len;
+		dump[len++] = '\n';
 	}
+
+	dump[len] = '\0';
+
+	return dump;
 }
 
-enum {
-	BUF_MAX = 2000,
-};
+int
+widget_headless_compare(const struct widget_points *points, const char *golden) {
+	char *dump = widget_headless_dump(points);
 
-static enum widget_error
-buf_add(struct input *input, uint32_t ch) {
-	if (((arrlenu(input->buf)) + 1) > BUF_MAX) {
-		return WIDGET_NOOP;
+	if (!dump || !golden) {
+		WIDGETS_FREE(dump);
+		return 0;
 	}
 
-	arrins(input->buf, input->cur_buf, ch);
-	input->cur_buf++;
+	int row = 0;
+	size_t i = 0;
 
-	return WIDGET_REDRAW;
+	for (; dump[i] && dump[i] == golden[i]; i++) {
+		if (dump[i] == '\n') {
+			row++;
+		}
+	}
+
+	bool equal = (dump[i] == golden[i]);
+	WIDGETS_FREE(dump);
+
+	return equal ? -1 : row;
+}
+#else
+static int
+screen_width(void) {
+	return tb_width();
 }
 
-static enum widget_error
-buf_left(struct input *input) {
-	if (input->cur_buf > 0) {
-		input->cur_buf--;
+static int
+screen_height(void) {
+	return tb_height();
+}
 
-		return WIDGET_REDRAW;
-	}
+static void
+screen_set_cell(int x, int y, uint32_t ch, uintattr_t fg, uintattr_t bg) {
+	tb_set_cell(x, y, ch, fg, bg);
+}
 
-	return WIDGET_NOOP;
+static void
+screen_set_cursor(int x, int y) {
+	tb_set_cursor(x, y);
 }
 
-static enum widget_error
-buf_leftword(struct input *input) {
-	if (input->cur_buf > 0) {
-		do {
-			input->cur_buf--;
-		} while (input->cur_buf > 0
-				 && ((iswspace((wint_t) input->buf[input->cur_buf]))
-					 || !(iswspace((wint_t) input->buf[input->cur_buf - 1]))));
+static void
+screen_clear(void) {
+	tb_clear();
+}
+#endif /* WIDGETS_HEADLESS */
 
-		return WIDGET_REDRAW;
-	}
+int
+widget_width(void) {
+	return screen_width();
+}
 
-	return WIDGET_NOOP;
+int
+widget_height(void) {
+	return screen_height();
 }
 
-static enum widget_error
-buf_right(struct input *input) {
-	if (input->cur_buf < arrlenu(input->buf)) {
-		input->cur_buf++;
+bool
+widget_points_in_bounds(const struct widget_points *points, int x, int y) {
+	return (
+	  x >= points->x1 && x < points->x2 && y >= points->y1 && y < points->y2);
+}
 
-		return WIDGET_REDRAW;
+/* Ensure that no point is negative or out of bounds. */
+void
+widget_points_set(
+  struct widget_points *points, int x1, int x2, int y1, int y2) {
+	if (!points) {
+		return;
 	}
 
-	return WIDGET_NOOP;
+	int height = screen_height();
+	int width = screen_width();
+
+	*points = (struct widget_points) {.x1 = min(max(0, x1), width),
+	  .x2 = min(max(0, x2), width),
+	  .y1 = min(max(0, y1), height),
+	  .y2 = min(max(0, y2), height)};
 }
 
-static enum widget_error
-buf_rightword(struct input *input) {
-	size_t buf_len = arrlenu(input->buf);
+/* Shadow of the frame being drawn, if any. */
+static struct widget_shadow *shadow_current = NULL;
 
-	if (input->cur_buf < buf_len) {
-		do {
-			input->cur_buf++;
-		} while (input->cur_buf < buf_len
-				 && !((iswspace((wint_t) input->buf[input->cur_buf]))
-					  && !(iswspace((wint_t) input->buf[input->cur_buf - 1]))));
+static const struct widget_cell cell_cleared = {
+  .ch = ' ', .fg = TB_DEFAULT, .bg = TB_DEFAULT};
 
-		return WIDGET_REDRAW;
+static bool
+cell_equal(const struct widget_cell *a, const struct widget_cell *b) {
+	return a->ch == b->ch && a->fg == b->fg && a->bg == b->bg;
+}
+
+static void
+shadow_damage(struct widget_shadow *shadow, int x, int y) {
+	struct widget_points *damage = &shadow->damage;
+
+	if (damage->x1 == damage->x2) {
+		*damage = (struct widget_points) {x, x + 1, y, y + 1};
+		return;
 	}
 
-	return WIDGET_NOOP;
+	*damage = (struct widget_points) {.x1 = min(damage->x1, x),
+	  .x2 = max(damage->x2, x + 1),
+	  .y1 = min(damage->y1, y),
+	  .y2 = max(damage->y2, y + 1)};
 }
 
-static enum widget_error
-buf_del(struct input *input) {
-	if (input->cur_buf > 0) {
-		--input->cur_buf;
+/* Fill the shadow with cleared cells, as termbox is after tb_clear(). */
+static int
+shadow_reset(struct widget_shadow *shadow, int width, int height) {
+	width = max(width, 0);
+	height = max(height, 0);
 
-		arrdel(input->buf, input->cur_buf);
+	size_t len = (size_t) width * (size_t) height;
 
-		return WIDGET_REDRAW;
+	WIDGETS_FREE(shadow->stamps);
+	WIDGETS_FREE(shadow->cells);
+
+	*shadow = (struct widget_shadow) {
+	  .width = width,
+	  .height = height,
+	  .stamps = len > 0 ? WIDGETS_MALLOC(len * sizeof(*shadow->stamps)) : NULL,
+	  .cells = len > 0 ? WIDGETS_MALLOC(len * sizeof(*shadow->cells)) : NULL,
+	};
+
+	if (len > 0 && (!shadow->stamps || !shadow->cells)) {
+		WIDGETS_FREE(shadow->stamps);
+		WIDGETS_FREE(shadow->cells);
+		*shadow = (struct widget_shadow) {0};
+
+		return -1;
 	}
 
-	return WIDGET_NOOP;
+	for (size_t i = 0; i < len; i++) {
+		shadow->stamps[i] = 0;
+		shadow->cells[i] = cell_cleared;
+	}
+
+	return 0;
 }
 
-static enum widget_error
-buf_delword(struct input *input) {
-	size_t original_cur = input->cur_buf;
+void
+widget_set_cell(int x, int y, uint32_t ch, uintattr_t fg, uintattr_t bg) {
+	struct widget_shadow *shadow = shadow_current;
 
-	if ((buf_leftword(input)) == WIDGET_REDRAW) {
-		arrdeln(input->buf, input->cur_buf, original_cur - input->cur_buf);
+	if (!shadow || x < 0 || x >= shadow->width || y < 0
+		|| y >= shadow->height) {
+		screen_set_cell(x, y, ch, fg, bg);
+		return;
+	}
 
-		return WIDGET_REDRAW;
+	size_t index = ((size_t) y * (size_t) shadow->width) + (size_t) x;
+	struct widget_cell cell = {.ch = ch, .fg = fg, .bg = bg};
+
+	shadow->stamps[index] = shadow->frame;
+
+	if (cell_equal(&shadow->cells[index], &cell)) {
+		return;
 	}
 
-	return WIDGET_NOOP;
+	shadow->cells[index] = cell;
+	shadow_damage(shadow, x, y);
+	screen_set_cell(x, y, ch, fg, bg);
 }
 
 int
-input_init(struct input *input, uintattr_t bg, bool scroll_horizontal) {
-	if (!input) {
+widget_shadow_init(struct widget_shadow *shadow) {
+	if (!shadow) {
 		return -1;
 	}
 
-	*input = (struct input) {.bg = bg, .scroll_horizontal = scroll_horizontal};
+	*shadow = (struct widget_shadow) {0};
 
-	return 0;
+	return shadow_reset(shadow, screen_width(), screen_height());
 }
 
 void
-input_finish(struct input *input) {
-	if (!input) {
+widget_shadow_finish(struct widget_shadow *shadow) {
+	if (!shadow) {
 		return;
 	}
 
-	arrfree(input->buf);
-	memset(input, 0, sizeof(*input));
-}
-
-void
-input_redraw(
-  struct input *input, struct widget_points *points, int *rows, bool dry_run) {
-	if (!rows) {
-		return;
+	if (shadow_current == shadow) {
+		shadow_current = NULL;
 	}
 
-	*rows = 0;
+	WIDGETS_FREE(shadow->stamps);
+	WIDGETS_FREE(shadow->cells);
+	memset(shadow, 0, sizeof(*shadow));
+}
 
-	/* Points might be invalid from the caller. */
-	if (!input || !points
-		|| !(widget_points_in_bounds(points, points->x1, points->y1))) {
+void
+widget_shadow_begin(struct widget_shadow *shadow) {
+	if (!shadow) {
 		return;
 	}
 
-	size_t buf_len = arrlenu(input->buf);
-
-	if (input->scroll_horizontal) {
-		*rows = 1;
+	int width = screen_width();
+	int height = screen_height();
 
-		if (dry_run) {
+	/* termbox keeps it's back buffer when resizing, so it's cleared to match
+	 * the reset shadow. Stale stamps could also be mistaken for the current
+	 * frame after the counter wraps around. */
+	if (width != shadow->width || height != shadow->height
+		|| shadow->frame == UINT_MAX) {
+		if ((shadow_reset(shadow, width, height)) != 0) {
 			return;
 		}
 
-		int width = 0;
-		int max_width = points->x2 - points->x1;
-		int start_width = -1;
-
-		for (size_t i = 0; i < (input->cur_buf + 1) && i < buf_len; i++) {
-			int ch_width = 0;
-			widget_uc_sanitize(input->buf[i], &ch_width);
+		screen_clear();
+	}
 
-			width += ch_width;
-		}
+	shadow->frame++;
 
-		if (width >= max_width) {
-			start_width = width - max_width;
-		}
+	shadow->damage = (struct widget_points) {0};
+	shadow_current = shadow;
+}
 
-		int x = points->x1;
+void
+widget_shadow_end(struct widget_shadow *shadow, struct widget_points *damage) {
+	if (!shadow) {
+		return;
+	}
 
-		width = 0;
-		size_t start = 0;
+	shadow_current = NULL;
 
-		for (; start < buf_len && width <= start_width; start++) {
-			int ch_width = 0;
-			widget_uc_sanitize(input->buf[start], &ch_width);
+	for (int y = 0; y < shadow->height; y++) {
+		for (int x = 0; x < shadow->width; x++) {
+			size_t index = ((size_t) y * (size_t) shadow->width) + (size_t) x;
 
-			width += ch_width;
+			if (shadow->stamps[index] != shadow->frame
+				&& !cell_equal(&shadow->cells[index], &cell_cleared)) {
+				shadow->cells[index] = cell_cleared;
+				shadow_damage(shadow, x, y);
+				screen_set_cell(x, y, cell_cleared.ch, cell_cleared.fg,
+				  cell_cleared.bg);
+			}
 		}
+	}
 
-		tb_set_cursor(points->x1, points->y1);
-
-		for (size_t i = start; i < buf_len; i++) {
-			int ch_width = 0;
-			uint32_t uc = widget_uc_sanitize(input->buf[i], &ch_width);
+	if (damage) {
+		*damage = shadow->damage;
+	}
+}
 
-			if ((x + ch_width) >= points->x2) {
-				break;
-			}
+bool
+widget_should_forcebreak(int width) {
+	return width == 0;
+}
 
-			if (!widget_should_forcebreak(ch_width)) {
-				tb_set_cell(x, points->y1, uc, TB_DEFAULT, input->bg);
-			}
+bool
+widget_should_scroll(int x, int width, int max_width) {
+	return (x > (max_width - width) || (widget_should_forcebreak(width)));
+}
 
-			x += ch_width;
+bool
+widget_advance_xy_if_scroll(
+  int *x, int *y, struct widget_points *points, int width) {
+	if (x && y && points && (widget_should_scroll(*x, width, points->x2))) {
+		*x = points->x1;
+		(*y)++;
 
-			if (i + 1 == input->cur_buf) {
-				tb_set_cursor(x, points->y1);
-			}
+		return true;
+	}
 
-			assert((widget_points_in_bounds(points, x, points->y1)));
-		}
+	return false;
+}
 
-		return;
+int
+widget_print_str(
+  int x, int y, int max_x, uintattr_t fg, uintattr_t bg, const char *str) {
+	if (!str) {
+		return 0;
 	}
 
-	int max_height = points->y2 - points->y1;
-	int cur_x = points->x1;
-	int cur_line = 1;
-	int lines = 1;
+	uint32_t uc = 0;
+	int width = 0;
+	int original = x;
 
-	{
-		int x = points->x1;
-		int width = 0;
+	while (*str) {
+		size_t run = ascii_run(str);
+
+		if (run > 0) {
+			size_t room = (size_t) max(max_x - x, 0);
+			size_t printed = min_size(run, room);
 
-		for (size_t written = 0; written < buf_len; written++) {
-			widget_uc_sanitize(input->buf[written], &width);
+			for (size_t i = 0; i < printed; i++) {
+				widget_set_cell(x++, y, (uint32_t) str[i], fg, bg);
+			}
 
-			widget_advance_xy_if_scroll(&x, &lines, points, width);
+			if (printed < run) {
+				break;
+			}
 
-			x += width;
+			str += run;
+			continue;
+		}
 
-			/* Check if adding another character would overflow the screen. This
-			 * prevents us from having the cursor stuck in the 1px gap between
-			 * points->x2 and points->x2 - 1 if the character was an emoji. */
-			widget_advance_xy_if_scroll(&x, &lines, points, WIDGET_CH_MAX);
+		int len = tb_utf8_char_to_unicode(&uc, str);
 
-			if ((written + 1) == input->cur_buf) {
-				cur_x = x;
-				cur_line = lines;
-			}
+		if (len == TB_ERR) {
+			break;
 		}
-	}
 
-	/* Don't mess up when coming back to the start after deleting a lot of
-	 * text. */
-	if (lines < max_height) {
-		input->start_y = 0;
-	}
+		str += len;
+		uc = widget_uc_sanitize(uc, &width);
 
-	int diff_forward = cur_line - (input->start_y + max_height);
-	int diff_backward = input->start_y - (cur_line - 1);
+		if ((widget_should_scroll(x, width, max_x))) {
+			break;
+		}
 
-	if (diff_backward > 0) {
-		input->start_y -= diff_backward;
-	} else if (diff_forward > 0) {
-		input->start_y += diff_forward;
+		widget_set_cell(x, y, uc, fg, bg);
+
+		x += width;
 	}
 
-	assert(input->start_y >= 0);
-	assert(input->start_y < lines);
+	return x - original;
+}
 
-	int width = 0;
-	int line = 0;
-	size_t written = 0;
+int
+widget_pad_center(int part, int total) {
+	int padding = (int) round(((double) (total - part)) / 2);
 
-	bool lines_fit_in_height = (lines < max_height);
+	if (padding < 0) {
+		return 0;
+	}
 
-	/* Calculate starting index. */
-	int y = lines_fit_in_height ? (points->y2 - lines) : points->y1;
+	return padding;
+}
 
-	for (int x = points->x1; written < buf_len; written++) {
-		if (line >= input->start_y) {
-			break;
-		}
+int
+widget_text_init(struct widget_text *text, const char *str) {
+	if (!text) {
+		return -1;
+	}
 
-		widget_uc_sanitize(input->buf[written], &width);
+	*text = (struct widget_text) {0};
 
-		line += widget_advance_xy_if_scroll(&x, &y, points, width);
-		x += width;
-		line += widget_advance_xy_if_scroll(&x, &y, points, WIDGET_CH_MAX);
-	}
+	size_t size = str ? strlen(str) : 0;
 
-	int cur_y = lines_fit_in_height
-				? (y + cur_line - 1)
-				: (points->y1 + (cur_line - (input->start_y + 1)));
+	/* There can't be more codepoints than bytes. */
+	arrsetcap(text->uc, size);
+	arrsetcap(text->columns, size + 1);
+	arrput(text->columns, 0);
 
-	assert((widget_points_in_bounds(points, cur_x, cur_y)));
+	bool forcebreak = false;
 
-	if (!dry_run) {
-		tb_set_cursor(cur_x, cur_y);
-	}
+	for (size_t i = 0; i < size;) {
+		uint32_t uc = 0;
+		int width = 0;
+		int len = tb_utf8_char_to_unicode(&uc, &str[i]);
 
-	for (int x = points->x1; written < buf_len; written++) {
-		if (line >= lines || (y - input->start_y) >= points->y2) {
+		if (len == TB_ERR) {
 			break;
 		}
 
-		assert((widget_points_in_bounds(points, x, y - input->start_y)));
+		i += (size_t) len;
+		uc = widget_uc_sanitize(uc, &width);
+		forcebreak = forcebreak || widget_should_forcebreak(width);
+
+		if (!forcebreak) {
+			text->printable++;
+		}
+
+		/* arrput() bumps the length while arrlast() reads it. */
+		int prev = arrlast(text->columns);
 
-		uint32_t uc = widget_uc_sanitize(input->buf[written], &width);
+		arrput(text->uc, uc);
+		arrput(text->columns, prev + width);
+	}
 
-		line += widget_advance_xy_if_scroll(&x, &y, points, width);
+	text->len = arrlenu(text->uc);
 
-		/* Don't print newlines directly as they mess up the screen. */
-		if (!widget_should_forcebreak(width) && !dry_run) {
-			tb_set_cell(x, y - input->start_y, uc, TB_DEFAULT, input->bg);
-		}
+	return 0;
+}
 
-		x += width;
-		line += widget_advance_xy_if_scroll(&x, &y, points, WIDGET_CH_MAX);
+void
+widget_text_finish(struct widget_text *text) {
+	if (!text) {
+		return;
 	}
 
-	*rows = (lines_fit_in_height ? (line + 1) : max_height);
+	arrfree(text->uc);
+	arrfree(text->columns);
+	memset(text, 0, sizeof(*text));
 }
 
-enum widget_error
-input_handle_event(struct input *input, enum input_event event, ...) {
-	if (!input) {
-		return WIDGET_NOOP;
+int
+widget_text_width(const struct widget_text *text) {
+	return text && text->columns ? text->columns[text->len] : 0;
+}
+
+size_t
+widget_text_fit(const struct widget_text *text, int max_width) {
+	if (!text || !text->columns || max_width <= 0) {
+		return 0;
 	}
 
-	switch (event) {
-	case INPUT_CLEAR:
-		if ((arrlenu(input->buf)) == 0) {
-			return WIDGET_NOOP;
-		}
+	/* Every printable codepoint is at least a column wide so the columns are
+	 * strictly increasing up to text->printable. */
+	size_t low = 0;
+	size_t high = text->printable;
 
-		input->cur_buf = 0;
-		arrsetlen(input->buf, 0);
-		return WIDGET_REDRAW;
-	case INPUT_DELETE:
-		return buf_del(input);
-	case INPUT_DELETE_WORD:
-		return buf_delword(input);
-	case INPUT_RIGHT:
-		return buf_right(input);
-	case INPUT_RIGHT_WORD:
-		return buf_rightword(input);
-	case INPUT_LEFT:
-		return buf_left(input);
-	case INPUT_LEFT_WORD:
-		return buf_leftword(input);
-	case INPUT_ADD:
-		{
-			va_list vl = {0};
-			va_start(vl, event);
-			/* https://bugs.llvm.org/show_bug.cgi?id=41311
-			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
-			uint32_t ch = va_arg(vl, uint32_t);
-			va_end(vl);
+	while (low < high) {
+		size_t mid = low + ((high - low + 1) / 2);
 
-			return buf_add(input, ch);
+		if (text->columns[mid] <= max_width) {
+			low = mid;
+		} else {
+			high = mid - 1;
 		}
-	default:
-		assert(0);
 	}
 
-	return WIDGET_NOOP;
+	return low;
 }
 
-char *
-input_buf(struct input *input) {
-	size_t len = arrlenu(input->buf);
-	enum { max_codepoint_len = 6 };
+int
+widget_text_print(const struct widget_text *text, int x, int y, int max_x,
+  uintattr_t fg, uintattr_t bg) {
+	size_t fit = widget_text_fit(text, max_x - x);
 
-	if (len == 0) {
-		return NULL;
+	for (size_t i = 0; i < fit; i++) {
+		widget_set_cell(x + text->columns[i], y, text->uc[i], fg, bg);
 	}
 
-	size_t size = 0;
+	return fit > 0 ? text->columns[fit] : 0;
+}
+
+enum {
+	BORDER_NORMAL = 0,
+	BORDER_CORNER_LEFT,
+	BORDER_CORNER_RIGHT,
+	BORDER_CORNER_LEFT_BOTTOM,
+	BORDER_CORNER_RIGHT_BOTTOM,
+	BORDER_VERTICAL,
+	BORDER_MAX
+};
 
-	char tmp[max_codepoint_len];
+static const char *const borders[BORDER_MAX] = {
+  [BORDER_NORMAL] = "─",
+  [BORDER_CORNER_LEFT] = "┌",
+  [BORDER_CORNER_RIGHT] = "┐",
+  [BORDER_CORNER_LEFT_BOTTOM] = "└",
+  [BORDER_CORNER_RIGHT_BOTTOM] = "┘",
+  [BORDER_VERTICAL] = "│",
+};
 
-	/* Calculate length. */
-	for (size_t i = 0; i < len; i++) {
-		size += (size_t) tb_utf8_unicode_to_char(tmp, input->buf[i]);
+void
+border_redraw(struct widget_points *points, uintattr_t fg, uintattr_t bg) {
+	if (!points) {
+		return;
 	}
 
-	if (size == 0) {
-		return NULL;
+	int height = points->y2 - points->y1;
+
+	for (int x = points->x1 + 1; x < (points->x2 - 1); x++) {
+		widget_print_str(
+		  x, points->y1, points->x2, fg, bg, borders[BORDER_NORMAL]);
 	}
 
-	char *buf = malloc((size + 1) * sizeof(*buf));
+	widget_print_str(
+	  points->x1, points->y1, points->x2, fg, bg, borders[BORDER_CORNER_LEFT]);
+	widget_print_str(points->x2 - 1, points->y1, points->x2, fg, bg,
+	  borders[BORDER_CORNER_RIGHT]);
 
-	if (!buf) {
-		return NULL;
+	/* Not points->y2 - 1 so that we write borders even if height < 2 */
+	for (int y = points->y1 + 1; y < points->y2; y++) {
+		widget_print_str(
+		  points->x1, y, points->x2, fg, bg, borders[BORDER_VERTICAL]);
+		widget_print_str(
+		  points->x2 - 1, y, points->x2, fg, bg, borders[BORDER_VERTICAL]);
 	}
 
-	for (size_t i = 0, i_utf8 = 0; i < size && i_utf8 < len; i_utf8++) {
-		i += (size_t) tb_utf8_unicode_to_char(&buf[i], input->buf[i_utf8]);
+	/* Don't overwrite the left/right or top connection. */
+	if (height > 2) {
+		widget_print_str(points->x1, points->y2 - 1, points->x2, fg, bg,
+		  borders[BORDER_CORNER_LEFT_BOTTOM]);
+		widget_print_str(points->x2 - 1, points->y2 - 1, points->x2, fg, bg,
+		  borders[BORDER_CORNER_RIGHT_BOTTOM]);
+
+		for (int x = points->x1 + 1; x < (points->x2 - 1); x++) {
+			widget_print_str(
+			  x, points->y2 - 1, points->x2, fg, bg, borders[BORDER_NORMAL]);
+		}
 	}
+}
 
-	/* Original size doesn't include + 1 for NUL so we don't need to subtract.
-	 */
-	buf[size] = '\0';
+enum {
+	BUF_MAX = 2000,
+	JOURNAL_MAX = 1 << 16,
+	HISTORY_MAX = 1 << 16,
+};
 
-	return buf;
+size_t
+input_len(const struct input *input) {
+	return input ? arrlenu(input->buf) - input->gap_len : 0;
 }
 
-/* If node is the parent's last child. */
-static bool
-is_last(const struct treeview_node *node) {
-	size_t len = node && node->parent ? arrlenu(node->parent->nodes) : 0;
-	return (len > 0 && node == node->parent->nodes[len - 1]);
+/* Number of bytes tb_utf8_unicode_to_char() writes for uc. */
+static size_t
+uc_utf8_len(uint32_t uc) {
+	return uc < 0x80 ? 1
+		 : uc < 0x800 ? 2
+		 : uc < 0x10000 ? 3
+		 : uc < 0x200000 ? 4
+		 : uc < 0x4000000 ? 5
+						  : 6;
 }
 
-static struct treeview_node *
-leaf(struct treeview_node *node) {
-	if (node->is_expanded && (arrlenu(node->nodes)) > 0) {
-		size_t len = arrlenu(node->nodes);
-		return leaf(node->nodes[len > 0 ? len - 1 : 0]);
-	}
+/* Codepoint at index i of the text, skipping over the gap. */
+static uint32_t
+buf_at(const struct input *input, size_t i) {
+	return input->buf[i < input->gap ? i : i + input->gap_len];
+}
 
-	return node;
+static size_t
+line_key(struct input_line line) {
+	return (line.start * 2) + line.checked;
 }
 
-static struct treeview_node *
-parent_next(struct treeview_node *node) {
-	if (node->parent) {
-		if ((node->parent->index + 1) < arrlenu(node->parent->nodes)) {
-			return node->parent->nodes[++node->parent->index];
-		}
+/* Index of the last line in the layout whose key is at most key. */
+static size_t
+layout_find(const struct input *input, size_t key) {
+	size_t low = 0;
+	size_t high = arrlenu(input->layout);
 
-		if (node->parent->parent) {
-			return parent_next(node->parent);
+	while ((high - low) > 1) {
+		size_t mid = low + ((high - low) / 2);
+
+		if ((line_key(input->layout[mid])) <= key) {
+			low = mid;
+		} else {
+			high = mid;
 		}
 	}
 
-	return node;
+	return low;
 }
 
-static int
-node_height_up_to_bottom(struct treeview_node *node) {
-	assert(node);
-
-	int height = 1;
-
-	if (!node->is_expanded) {
-		return height;
+/* Drops the lines that could be changed by an edit at index pos. Lines
+ * started by wrapping after the previous codepoint stay valid. */
+static void
+layout_invalidate(struct input *input, size_t pos) {
+	if ((arrlenu(input->layout)) > 0) {
+		arrsetlen(input->layout, (layout_find(input, pos * 2)) + 1);
+		input->layout_done = false;
 	}
+}
 
-	for (size_t i = 0, len = arrlenu(node->nodes); i < len; i++) {
-		height += node_height_up_to_bottom(node->nodes[i]);
+/* Keeps the horizontal view on the same text after removed codepoints at
+ * index pos were replaced by added ones. */
+static void
+view_edit(struct input *input, size_t pos, size_t removed, size_t added) {
+	if ((pos + removed) <= input->view_start) {
+		input->view_start = input->view_start - removed + added;
+		input->view_end = input->view_end - removed + added;
+	} else if (pos < input->view_end) {
+		input->view_valid = false;
 	}
+}
 
-	return height;
+static void
+journal_reset(struct input_journal *journal) {
+	journal->merge = false;
+	journal->ring = journal->max;
+	journal->first = journal->pos = journal->end = 0;
+	arrsetlen(journal->edits, 0);
+	arrsetlen(journal->text, 0);
 }
 
-static int
-node_height_bottom_to_up(struct treeview_node *node) {
-	assert(node);
+static uint32_t
+journal_at(const struct input_journal *journal, size_t offset) {
+	return journal->text[offset % journal->ring];
+}
 
-	int height = 1;
+static void
+journal_append(struct input_journal *journal, const uint32_t *src, size_t len) {
+	/* The text only grows up to the size of the ring. */
+	size_t size = min_size(journal->end + len, journal->ring);
 
-	if (!node->parent) {
-		return height;
+	if ((arrlenu(journal->text)) < size) {
+		arrsetlen(journal->text,
+		  min_size(max_size(arrlenu(journal->text) * 2, size), journal->ring));
 	}
 
-	assert(node->parent->is_expanded);
+	size_t start = journal->end % journal->ring;
+	size_t head = min_size(len, journal->ring - start);
 
-	for (size_t i = 0, len = arrlenu(node->parent->nodes); i < len; i++) {
-		if (node->parent->nodes[i] == node) {
-			break;
-		}
+	memcpy(&journal->text[start], src, head * sizeof(*src));
+	memcpy(journal->text, &src[head], (len - head) * sizeof(*src));
 
-		height += node_height_up_to_bottom(node->parent->nodes[i]);
-	}
+	journal->end += len;
 
-	return height + node_height_bottom_to_up(node->parent);
-}
+	/* Drop the edits whose text was overwritten. */
+	while (journal->first < journal->pos
+		   && (journal->end - journal->edits[journal->first].offset)
+				> journal->ring) {
+		journal->first++;
+	}
 
-static int
-redraw(struct treeview *treeview, const struct treeview_node *node,
-  const struct widget_points *points, int x, int y) {
-	if (!node) {
-		return y;
+	/* Whatever the oldest edit was chained to is gone. */
+	if (journal->first < journal->pos) {
+		journal->edits[journal->first].chain = false;
 	}
 
-	assert((widget_points_in_bounds(points, x, y)));
+	if (journal->first > 0 && (journal->first * 2) > arrlenu(journal->edits)) {
+		arrdeln(journal->edits, 0, journal->first);
+		journal->pos -= journal->first;
+		journal->first = 0;
+	}
+}
 
-	/* Stolen from tview's semigraphics. */
-	const char symbol[] = "├──";
-	const char symbol_end[] = "└──";
-	const char symbol_continued[] = "│";
-	const int gap_size = 3; /* Width of the above symbols (first 3). */
+/* Records that len codepoints from src were inserted or erased at index pos.
+ * Single codepoints are merged into the last edit until a word starts. */
+static void
+journal_record(struct input *input, bool insert, size_t pos,
+  const uint32_t *src, size_t len) {
+	struct input_journal *journal = &input->journal;
 
-	bool is_end = is_last(node);
-	bool is_not_top_level = (node->parent && node->parent->parent);
-	int symbol_printed_width = (is_not_top_level ? gap_size : 0);
+	if (journal->applying || len == 0) {
+		return;
+	}
 
-	/* Skip the given offset before actually printing stuff. */
-	if (node->parent && treeview->skipped++ >= treeview->start_y) {
-		if (is_not_top_level) {
-			widget_print_str(x, y, points->x2, TB_DEFAULT, TB_DEFAULT,
-			  (is_end ? symbol_end : symbol));
-		}
+	if (journal->max != journal->ring || len > journal->max) {
+		journal_reset(journal);
+	}
 
-		struct widget_points user_points = {0};
-		widget_points_set(
-		  &user_points, x + symbol_printed_width, points->x2, y, points->y2);
+	if (journal->max == 0 || len > journal->max) {
+		return;
+	}
 
-		node->draw_cb(node->data, &user_points, (node == treeview->selected));
-		y++; /* Next node will be on another line. */
+	/* A new edit can't be followed by the undone ones. */
+	if (journal->pos < arrlenu(journal->edits)) {
+		journal->end = journal->edits[journal->pos].offset;
+		arrsetlen(journal->edits, journal->pos);
 	}
 
-	if (!node->is_expanded || (x + symbol_printed_width) >= points->x2) {
-		return y;
+	struct input_edit *last = journal->pos > journal->first
+							  ? &journal->edits[journal->pos - 1]
+							  : NULL;
+	bool merge = journal->merge && !journal->chain && last && len == 1
+			  && !(!(iswspace((wint_t) src[0]))
+				   && (iswspace((wint_t) journal_at(
+					 journal, last->offset + last->len - 1))));
+
+	journal->merge = (len == 1);
+
+	if (merge && insert && last->insert
+		&& pos == (last->pos + last->len)) {
+		last->len++;
+		journal_append(journal, src, len);
+		return;
 	}
 
-	for (size_t i = 0, len = arrlenu(node->nodes); i < len && y < points->y2;
-		 i++) {
-		int delta = redraw(treeview, node->nodes[i], points,
-					  x + symbol_printed_width, y)
-				  - y;
-
-		/* We can cheat here and avoid backtracking to show the parent-child
-		 * relation by just filling the gaps as we would if we inspected them
-		 * ourselves. */
-		if (is_not_top_level && !is_end) {
-			for (int j = 0; j < delta; j++) {
-				widget_print_str(
-				  x, y++, points->x2, TB_DEFAULT, TB_DEFAULT, symbol_continued);
-			}
-		} else {
-			y += delta;
-		}
+	/* Erasing backwards stores the text in reverse. */
+	if (merge && !insert && !last->insert && (pos + 1) == last->pos
+		&& (last->reversed || last->len == 1)) {
+		last->reversed = true;
+		last->pos--;
+		last->len++;
+		journal_append(journal, src, len);
+		return;
 	}
 
-	return y;
+	arrput(journal->edits,
+	  ((struct input_edit) {.insert = insert,
+		.chain = journal->chain,
+		.pos = pos,
+		.len = len,
+		.offset = journal->end}));
+	journal->pos = arrlenu(journal->edits);
+	journal_append(journal, src, len);
 }
 
-int
-treeview_node_init(
-  struct treeview_node *node, void *data, treeview_draw_cb draw_cb) {
-	if (!node || !draw_cb) {
-		return -1;
+/* Moves the gap to start at index pos of the text. */
+static void
+buf_gap_move(struct input *input, size_t pos) {
+	uint32_t *buf = input->buf;
+
+	if (pos < input->gap) {
+		memmove(&buf[pos + input->gap_len], &buf[pos],
+		  (input->gap - pos) * sizeof(*buf));
+	} else if (pos > input->gap) {
+		memmove(&buf[input->gap], &buf[input->gap + input->gap_len],
+		  (pos - input->gap) * sizeof(*buf));
 	}
 
-	*node = (struct treeview_node) {
-	  .is_expanded = true, .data = data, .draw_cb = draw_cb};
-
-	return 0;
+	input->gap = pos;
 }
 
-struct treeview_node *
-treeview_node_alloc(void *data, treeview_draw_cb draw_cb) {
-	struct treeview_node *node = draw_cb ? malloc(sizeof(*node)) : NULL;
-
-	if (node) {
-		treeview_node_init(node, data, draw_cb);
+/* Makes room for len codepoints at index pos of the text and returns where
+ * they should be written. */
+static uint32_t *
+buf_reserve(struct input *input, size_t pos, size_t len) {
+	layout_invalidate(input, pos);
+	buf_gap_move(input, pos);
+
+	if (input->gap_len < len) {
+		size_t old_len = arrlenu(input->buf);
+		size_t tail = old_len - (input->gap + input->gap_len);
+		size_t new_len = max_size(old_len - input->gap_len + len, old_len * 2);
+
+		arrsetlen(input->buf, max_size(new_len, 16));
+		memmove(&input->buf[arrlenu(input->buf) - tail],
+		  &input->buf[old_len - tail], tail * sizeof(*input->buf));
+		input->gap_len += arrlenu(input->buf) - old_len;
 	}
 
-	return node;
+	return &input->buf[input->gap];
 }
 
-int
-treeview_node_add_child(
-  struct treeview_node *parent, struct treeview_node *child) {
-	if (!parent || !child || parent == child) {
-		return -1;
+/* Marks len codepoints written after buf_reserve() as part of the text. */
+static void
+buf_commit(struct input *input, size_t len) {
+	for (size_t i = 0; i < len; i++) {
+		input->utf8_len += uc_utf8_len(input->buf[input->gap + i]);
 	}
 
-	child->parent = parent;
-	arrput(parent->nodes, child);
+	view_edit(input, input->gap, 0, len);
+	journal_record(input, true, input->gap, &input->buf[input->gap], len);
+	input->gap += len;
+	input->gap_len -= len;
+}
 
-	return 0;
+/* Inserts len codepoints at index pos of the text. */
+static void
+buf_insert(struct input *input, size_t pos, const uint32_t *src, size_t len) {
+	memcpy(buf_reserve(input, pos, len), src, len * sizeof(*src));
+	buf_commit(input, len);
 }
 
+/* Erases len codepoints at index pos of the text. */
 static void
-node_children_destroy(struct treeview_node *node) {
-	if (node->nodes) {
-		for (size_t i = 0, len = arrlenu(node->nodes); i < len; i++) {
-			treeview_node_destroy(node->nodes[i]);
-		}
+buf_erase(struct input *input, size_t pos, size_t len) {
+	layout_invalidate(input, pos);
+	buf_gap_move(input, pos);
 
-		arrfree(node->nodes);
+	for (size_t i = 0; i < len; i++) {
+		input->utf8_len
+		  -= uc_utf8_len(input->buf[input->gap + input->gap_len + i]);
 	}
+
+	view_edit(input, pos, len, 0);
+	journal_record(
+	  input, false, pos, &input->buf[input->gap + input->gap_len], len);
+	input->gap_len += len;
 }
 
-void
-treeview_node_destroy(struct treeview_node *node) {
-	if (!node) {
-		return;
+/* Inserts the text of edit back into the input. */
+static void
+journal_insert(struct input *input, const struct input_edit *edit) {
+	uint32_t *dst = buf_reserve(input, edit->pos, edit->len);
+
+	for (size_t i = 0; i < edit->len; i++) {
+		size_t offset = edit->reversed ? (edit->len - 1 - i) : i;
+		dst[i] = journal_at(&input->journal, edit->offset + offset);
 	}
 
-	node_children_destroy(node);
-	free(node);
+	buf_commit(input, edit->len);
 }
 
-void
-treeview_node_finish(struct treeview_node *node) {
-	if (!node) {
-		return;
-	}
+static enum widget_error
+buf_undo(struct input *input) {
+	struct input_journal *journal = &input->journal;
 
-	for (size_t i = 0, len = arrlenu(node->nodes); i < len; i++) {
-		treeview_node_finish(node->nodes[i]);
+	if (journal->pos == journal->first || journal->max != journal->ring) {
+		return WIDGET_NOOP;
 	}
 
-	arrfree(node->nodes);
-	memset(node, 0, sizeof(*node));
-}
+	const struct input_edit *edit = NULL;
 
-int
-treeview_init(struct treeview *treeview) {
-	if (!treeview) {
-		return -1;
-	}
+	journal->applying = true;
 
-	*treeview = (struct treeview) {
-	  .root = {
-	  	.is_expanded = true,
-	  },
-	};
+	do {
+		edit = &journal->edits[--journal->pos];
 
-	return 0;
-}
+		if (edit->insert) {
+			buf_erase(input, edit->pos, edit->len);
+			input->cur_buf = edit->pos;
+		} else {
+			journal_insert(input, edit);
+			input->cur_buf = edit->pos + edit->len;
+		}
+	} while (edit->chain && journal->pos > journal->first);
 
-void
-treeview_finish(struct treeview *treeview) {
-	if (treeview) {
-		node_children_destroy(&treeview->root);
-		memset(treeview, 0, sizeof(*treeview));
-	}
+	journal->applying = false;
+
+	return WIDGET_REDRAW;
 }
 
-void
-treeview_redraw(struct treeview *treeview, struct widget_points *points) {
-	if (!treeview || !treeview->selected || !points
-		|| !(widget_points_in_bounds(points, points->x1, points->y1))) {
-		return;
+static enum widget_error
+buf_redo(struct input *input) {
+	struct input_journal *journal = &input->journal;
+
+	if (journal->pos == arrlenu(journal->edits)
+		|| journal->max != journal->ring) {
+		return WIDGET_NOOP;
 	}
 
-	/* -1 as the root node is not visible. */
-	int selected_height = node_height_bottom_to_up(treeview->selected) - 1;
+	journal->applying = true;
 
-	assert(selected_height > 0);
+	do {
+		const struct input_edit *edit = &journal->edits[journal->pos++];
 
-	int diff_forward
-	  = selected_height - (treeview->start_y + (points->y2 - points->y1));
-	int diff_backward = treeview->start_y - (selected_height - 1);
+		if (edit->insert) {
+			journal_insert(input, edit);
+			input->cur_buf = edit->pos + edit->len;
+		} else {
+			buf_erase(input, edit->pos, edit->len);
+			input->cur_buf = edit->pos;
+		}
+	} while (journal->pos < arrlenu(journal->edits)
+			 && journal->edits[journal->pos].chain);
 
-	if (diff_backward > 0) {
-		treeview->start_y -= diff_backward;
-	} else if (diff_forward > 0) {
-		treeview->start_y += diff_forward;
+	journal->applying = false;
+
+	return WIDGET_REDRAW;
+}
+
+static enum widget_error
+buf_add(struct input *input, uint32_t ch) {
+	if (input->max_len > 0 && ((input_len(input)) + 1) > input->max_len) {
+		return WIDGET_NOOP;
 	}
 
-	assert(treeview->start_y >= 0);
-	assert(treeview->start_y < selected_height);
+	buf_insert(input, input->cur_buf, &ch, 1);
+	input->cur_buf++;
+
+	return WIDGET_REDRAW;
+}
+
+/* Number of codepoints that can still be added. */
+static size_t
+buf_room(const struct input *input) {
+	size_t len = input_len(input);
 
-	redraw(treeview, &treeview->root, points, points->x1, points->y1);
+	if (input->max_len == 0) {
+		return SIZE_MAX - len;
+	}
 
-	/* Reset the number of skipped lines. */
-	treeview->skipped = 0;
+	return input->max_len > len ? input->max_len - len : 0;
 }
 
-enum widget_error
-treeview_event(struct treeview *treeview, enum treeview_event event, ...) {
-	if (!treeview) {
+/* Decoding stops at a NUL or an incomplete codepoint at the end. */
+static enum widget_error
+buf_add_str(struct input *input, const char *str, size_t size) {
+	size_t room = buf_room(input);
+
+	if (!str || size == 0 || room == 0) {
 		return WIDGET_NOOP;
 	}
 
-	switch (event) {
-	case TREEVIEW_EXPAND:
-		if (!treeview->selected) {
-			break;
-		}
+	/* There can't be more codepoints than bytes. */
+	uint32_t *dst = buf_reserve(input, input->cur_buf, min_size(size, room));
+	size_t len = 0;
 
-		treeview->selected->is_expanded = !treeview->selected->is_expanded;
-		return WIDGET_REDRAW;
-	case TREEVIEW_UP:
-		if (!treeview->selected) {
+	for (size_t i = 0; i < size && len < room;) {
+		if ((size_t) tb_utf8_char_length(str[i]) > (size - i)) {
 			break;
 		}
 
-		if (treeview->selected->parent->index > 0) {
-			treeview->selected = treeview->selected->parent
-								   ->nodes[--treeview->selected->parent->index];
-			treeview->selected = leaf(treeview->selected); /* Bottom node. */
-		} else if (treeview->selected->parent->parent) {
-			treeview->selected = treeview->selected->parent;
-		} else if (treeview->selected == treeview->root.nodes[0]) {
-			treeview->start_y = 0; /* Scroll up to the title if we're already at
-								  the top-most node. */
-		} else {
-			break;
-		}
+		int ch_len = tb_utf8_char_to_unicode(&dst[len], &str[i]);
 
-		return WIDGET_REDRAW;
-	case TREEVIEW_DOWN:
-		if (!treeview->selected) {
+		if (ch_len == TB_ERR) {
 			break;
 		}
 
-		if (treeview->selected->is_expanded
-			&& (arrlenu(treeview->selected->nodes)) > 0) {
-			treeview->selected = treeview->selected->nodes[0]; /* First node. */
-		} else {
-			/* Ensure that we don't create a loop between the end-most node of
-			 * the tree and it's parent at the root. */
-			if (treeview->selected != (leaf(&treeview->root))) {
-				treeview->selected = parent_next(treeview->selected);
-			}
-		}
+		i += (size_t) ch_len;
+		len++;
+	}
 
-		return WIDGET_REDRAW;
-	case TREEVIEW_INSERT:
-		{
-			if (!treeview->selected) {
-				break;
-			}
+	buf_commit(input, len);
+	input->cur_buf += len;
 
-			va_list vl = {0};
-			va_start(vl, event);
-			/* https://bugs.llvm.org/show_bug.cgi?id=41311
-			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
-			struct treeview_node *nnode = va_arg(vl, struct treeview_node *);
-			va_end(vl);
+	return len > 0 ? WIDGET_REDRAW : WIDGET_NOOP;
+}
 
-			if (!nnode) {
-				break;
-			}
+static enum widget_error
+buf_add_utf32(struct input *input, const uint32_t *str, size_t len) {
+	len = min_size(len, buf_room(input));
 
-			nnode->parent = treeview->selected;
-			arrput(treeview->selected->nodes, nnode);
+	if (!str || len == 0) {
+		return WIDGET_NOOP;
+	}
 
-			return WIDGET_REDRAW;
-		}
-	case TREEVIEW_INSERT_PARENT:
-		{
-			va_list vl = {0};
-			va_start(vl, event);
-			/* https://bugs.llvm.org/show_bug.cgi?id=41311
-			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
-			struct treeview_node *nnode = va_arg(vl, struct treeview_node *);
-			va_end(vl);
+	buf_insert(input, input->cur_buf, str, len);
+	input->cur_buf += len;
 
-			if (!nnode) {
-				break;
-			}
+	return WIDGET_REDRAW;
+}
 
-			nnode->parent = !treeview->selected ? &treeview->root
-												: treeview->selected->parent;
-			arrput(nnode->parent->nodes, nnode);
+static enum widget_error
+buf_left(struct input *input) {
+	if (input->cur_buf > 0) {
+		input->cur_buf--;
 
-			/* We don't adjust indexes or set the selected tree unless it's the
-			 * first entry. This is done to avoid accounting for the cases where
-			 * we ascend to the top of a node, add a new node below it in the
-			 * parent's trees and then try moving back to the node where all
-			 * indices are set to 0. */
-			if (!treeview->selected) {
-				treeview->selected = nnode;
-			}
+		return WIDGET_REDRAW;
+	}
 
-			return WIDGET_REDRAW;
-		}
-	case TREEVIEW_JUMP:
-		{
-			va_list vl = {0};
-			va_start(vl, event);
-			/* https://bugs.llvm.org/show_bug.cgi?id=41311
-			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
-			struct treeview_node *nnode = va_arg(vl, struct treeview_node *);
-			va_end(vl);
+	return WIDGET_NOOP;
+}
 
-			if (!nnode) {
-				break;
-			}
+static enum widget_error
+buf_leftword(struct input *input) {
+	if (input->cur_buf > 0) {
+		do {
+			input->cur_buf--;
+		} while (input->cur_buf > 0
+				 && ((iswspace((wint_t) buf_at(input, input->cur_buf)))
+					 || !(iswspace(
+					   (wint_t) buf_at(input, input->cur_buf - 1)))));
 
-			assert(nnode->parent);
+		return WIDGET_REDRAW;
+	}
 
-			bool found = false;
+	return WIDGET_NOOP;
+}
 
-			if (treeview->selected) {
-				while (treeview->selected->parent) {
-					treeview->selected->parent->index = 0;
-					treeview->selected = treeview->selected->parent;
-				}
+static enum widget_error
+buf_right(struct input *input) {
+	if (input->cur_buf < input_len(input)) {
+		input->cur_buf++;
 
-				treeview->selected = NULL;
-			}
+		return WIDGET_REDRAW;
+	}
+
+	return WIDGET_NOOP;
+}
+
+static enum widget_error
+buf_rightword(struct input *input) {
+	size_t buf_len = input_len(input);
 
-			for (size_t i = 0, len = arrlenu(nnode->parent->nodes); i < len;
-				 i++) {
-				if (nnode->parent->nodes[i] == nnode) {
-					found = true;
-					nnode->parent->index = i;
+	if (input->cur_buf < buf_len) {
+		do {
+			input->cur_buf++;
+		} while (input->cur_buf < buf_len
+				 && !((iswspace((wint_t) buf_at(input, input->cur_buf)))
+					  && !(iswspace(
+						(wint_t) buf_at(input, input->cur_buf - 1)))));
 
-					if (nnode->parent->parent) {
-						treeview_event(treeview, TREEVIEW_JUMP, nnode->parent);
-					}
+		return WIDGET_REDRAW;
+	}
 
-					break;
-				}
-			}
+	return WIDGET_NOOP;
+}
 
-			assert(found);
-			treeview->selected = nnode;
+static enum widget_error
+buf_del(struct input *input) {
+	if (input->cur_buf > 0) {
+		--input->cur_buf;
 
-			return WIDGET_REDRAW;
-		}
-	case TREEVIEW_DELETE:
-		{
-			struct treeview_node *current = treeview->selected;
+		buf_erase(input, input->cur_buf, 1);
 
-			if (!current) {
-				break;
-			}
+		return WIDGET_REDRAW;
+	}
 
-			arrdel(current->parent->nodes, current->parent->index);
+	return WIDGET_NOOP;
+}
 
-			if (current->parent->index < arrlenu(current->parent->nodes)) {
-				treeview->selected
-				  = current->parent->nodes[current->parent->index];
-			} else if (current->parent->index > 0) {
-				treeview->selected
-				  = current->parent->nodes[--current->parent->index];
-			} else if (current->parent->parent) {
-				/* Move up a level. */
-				treeview->selected = current->parent;
-			} else {
-				/* At top level and all nodes deleted. */
-				treeview->selected = NULL;
-			}
+static enum widget_error
+buf_delword(struct input *input) {
+	size_t original_cur = input->cur_buf;
 
-			treeview_node_destroy(current);
+	if ((buf_leftword(input)) == WIDGET_REDRAW) {
+		buf_erase(input, input->cur_buf, original_cur - input->cur_buf);
 
-			return WIDGET_REDRAW;
-		}
-	default:
-		assert(0);
-		break;
+		return WIDGET_REDRAW;
 	}
 
 	return WIDGET_NOOP;
 }
 
-#ifdef WIDGETS_TESTS
-#include <assert.h>
-#include <locale.h>
+/* Walks the wrapped line starting at line up to the codepoint at index stop,
+ * drawing it at row y if draw is set. x is set to the column reached. Returns
+ * true and sets line to the start of the next line if the line ended first.
+ *
+ * A codepoint goes on the next line if it doesn't fit or is a newline, and the
+ * line is also ended after a codepoint if a wide one wouldn't fit anymore. This
+ * prevents us from having the cursor stuck in the 1px gap between points->x2
+ * and points->x2 - 1 if the character was an emoji. */
+static bool
+line_walk(const struct input *input, const struct widget_points *points,
+  struct input_line *line, size_t stop, int *x, int y, bool draw) {
+	int max_width = points->x2 - points->x1;
 
-int
-main(void) {
-	assert(tb_init() == TB_OK);
-	setlocale(LC_ALL, "");
+	*x = 0;
 
-	{
-		struct widget_points points = {0};
+	for (size_t i = line->start; i < stop; i++) {
+		int width = 0;
+		uint32_t uc = widget_uc_sanitize(buf_at(input, i), &width);
 
-		widget_points_set(&points, 0, 1, 0, 1);
-		assert(widget_points_in_bounds(&points, points.x1, points.y1));
-		widget_points_set(&points, 0, 2, 5, 5);
-		assert(!widget_points_in_bounds(&points, points.x1, points.y1));
-		widget_points_set(&points, 5, 5, 5, 5);
-		assert(!widget_points_in_bounds(&points, points.x1, points.y1));
-		widget_points_set(&points, -1, tb_width() + 1, -1, tb_height() + 1);
-		assert(points.x1 == 0);
-		assert(points.x2 == tb_width());
-		assert(points.y1 == 0);
-		assert(points.y2 == tb_height());
+		if ((i != line->start || !line->checked)
+			&& (widget_should_scroll(*x, width, max_width))) {
+			*line = (struct input_line) {.start = i, .checked = true};
+			return true;
+		}
+
+		/* Don't print newlines directly as they mess up the screen. */
+		if (draw && !widget_should_forcebreak(width)) {
+			widget_set_cell(points->x1 + *x, y, uc, TB_DEFAULT, input->bg);
+		}
+
+		*x += width;
+
+		if ((widget_should_scroll(*x, WIDGET_CH_MAX, max_width))) {
+			*line = (struct input_line) {.start = i + 1};
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int
+buf_width(const struct input *input, size_t i) {
+	int width = 0;
+	widget_uc_sanitize(buf_at(input, i), &width);
+
+	return width;
+}
+
+/* Moves the horizontal view so that it ends with the codepoint under the
+ * cursor and starts as far left as the width allows. */
+static void
+view_update(struct input *input, int max_width) {
+	size_t end = min_size(input->cur_buf + 1, input_len(input));
+
+	/* Starting over is cheaper than sliding far. */
+	if (!input->view_valid || end < input->view_start
+		|| (end - input->view_start) > (size_t) max_width * 2) {
+		input->view_valid = true;
+		input->view_width = 0;
+		input->view_start = input->view_end = end;
+	}
+
+	while (input->view_end < end) {
+		input->view_width += buf_width(input, input->view_end++);
+	}
+
+	while (input->view_end > end) {
+		input->view_width -= buf_width(input, --input->view_end);
+	}
+
+	while (input->view_width >= max_width) {
+		input->view_width -= buf_width(input, input->view_start++);
+	}
+
+	while (input->view_start > 0
+		   && (input->view_width + (buf_width(input, input->view_start - 1)))
+				< max_width) {
+		input->view_width += buf_width(input, --input->view_start);
+	}
+}
+
+/* Lays out one more line, returns false if there are none left. */
+static bool
+layout_next(struct input *input, const struct widget_points *points) {
+	if (input->layout_done) {
+		return false;
+	}
+
+	struct input_line line = arrlast(input->layout);
+	int x = 0;
+
+	if (!(line_walk(input, points, &line, input_len(input), &x, 0, false))) {
+		input->layout_done = true;
+		return false;
+	}
+
+	arrput(input->layout, line);
+
+	return true;
+}
+
+/* Starts the layout over if the width of points changed. */
+static void
+layout_prepare(struct input *input, const struct widget_points *points) {
+	int max_width = points->x2 - points->x1;
+
+	if ((arrlenu(input->layout)) == 0 || input->layout_width != max_width) {
+		arrsetlen(input->layout, 0);
+		arrput(input->layout, (struct input_line) {0});
+		input->layout_width = max_width;
+		input->layout_done = false;
+	}
+}
+
+/* Index of the line the cursor is on, laying out lines up to it. */
+static size_t
+layout_cursor_line(struct input *input, const struct widget_points *points) {
+	while ((line_key(arrlast(input->layout))) <= (input->cur_buf * 2)
+		   && (layout_next(input, points))) {}
+
+	return layout_find(input, input->cur_buf * 2);
+}
+
+int
+input_init(struct input *input, uintattr_t bg, bool scroll_horizontal) {
+	if (!input) {
+		return -1;
+	}
+
+	*input = (struct input) {.bg = bg,
+	  .scroll_horizontal = scroll_horizontal,
+	  .max_len = BUF_MAX,
+	  .goal_x = -1,
+	  .journal = {.max = JOURNAL_MAX},
+	  .history = {.max = HISTORY_MAX}};
+
+	return 0;
+}
+
+void
+input_finish(struct input *input) {
+	if (!input) {
+		return;
+	}
+
+	arrfree(input->buf);
+	arrfree(input->layout);
+	arrfree(input->journal.edits);
+	arrfree(input->journal.text);
+	arrfree(input->history.entries);
+	arrfree(input->history.sorted);
+	arrfree(input->history.text);
+	memset(input, 0, sizeof(*input));
+}
+
+void
+input_redraw(
+  struct input *input, struct widget_points *points, int *rows, bool dry_run) {
+	if (!rows) {
+		return;
+	}
+
+	*rows = 0;
+
+	/* Points might be invalid from the caller. */
+	if (!input || !points
+		|| !(widget_points_in_bounds(points, points->x1, points->y1))) {
+		return;
+	}
+
+	size_t buf_len = input_len(input);
+
+	input->points = *points;
+
+	if (input->scroll_horizontal) {
+		*rows = input->rows = 1;
+
+		if (dry_run) {
+			return;
+		}
+
+		int x = points->x1;
+
+		view_update(input, points->x2 - points->x1);
+
+		input->cur_x = points->x1;
+		input->cur_y = points->y1;
+
+		for (size_t i = input->view_start; i < buf_len; i++) {
+			int ch_width = 0;
+			uint32_t uc = widget_uc_sanitize(buf_at(input, i), &ch_width);
+
+			if ((x + ch_width) >= points->x2) {
+				break;
+			}
+
+			if (!widget_should_forcebreak(ch_width)) {
+				widget_set_cell(x, points->y1, uc, TB_DEFAULT, input->bg);
+			}
+
+			x += ch_width;
+
+			if (i + 1 == input->cur_buf) {
+				input->cur_x = x;
+			}
+
+			assert((widget_points_in_bounds(points, x, points->y1)));
+		}
+
+		screen_set_cursor(input->cur_x, input->cur_y);
+
+		return;
+	}
+
+	int max_height = points->y2 - points->y1;
+
+	layout_prepare(input, points);
+
+	/* Only lay out as far as needed to know whether all lines fit and where the
+	 * cursor is. */
+	while ((arrlenu(input->layout)) < (size_t) max_height
+		   && (layout_next(input, points))) {}
+
+	int cur_line = (int) layout_cursor_line(input, points);
+	bool lines_fit_in_height
+	  = input->layout_done && (arrlenu(input->layout)) < (size_t) max_height;
+
+	/* Don't mess up when coming back to the start after deleting a lot of
+	 * text. */
+	if (lines_fit_in_height) {
+		input->start_y = 0;
+	}
+
+	int diff_forward = (cur_line + 1) - (input->start_y + max_height);
+	int diff_backward = input->start_y - cur_line;
+
+	if (diff_backward > 0) {
+		input->start_y -= diff_backward;
+	} else if (diff_forward > 0) {
+		input->start_y += diff_forward;
+	}
+
+	while ((arrlenu(input->layout)) < (size_t) (input->start_y + max_height)
+		   && (layout_next(input, points))) {}
+
+	int lines = (int) arrlenu(input->layout);
+
+	assert(input->start_y >= 0);
+	assert(input->start_y < lines);
+
+	/* Row of the first visible line. */
+	int y = lines_fit_in_height ? (points->y2 - lines) : points->y1;
+	struct input_line line = input->layout[cur_line];
+	int cur_x = 0;
+
+	line_walk(input, points, &line, input->cur_buf, &cur_x, 0, false);
+
+	input->cur_x = points->x1 + cur_x;
+	input->cur_y = y + (cur_line - input->start_y);
+
+	assert((widget_points_in_bounds(points, input->cur_x, input->cur_y)));
+
+	if (!dry_run) {
+		screen_set_cursor(input->cur_x, input->cur_y);
+
+		for (int i = input->start_y;
+			 i < lines && i < (input->start_y + max_height); i++) {
+			int x = 0;
+
+			line = input->layout[i];
+			line_walk(input, points, &line, input_len(input), &x,
+			  y + (i - input->start_y), true);
+		}
+	}
+
+	*rows = input->rows = (lines_fit_in_height ? lines : max_height);
+}
+
+static size_t
+history_next_id(const struct input_history *history) {
+	return history->base + arrlenu(history->entries);
+}
+
+static const struct input_history_entry *
+history_entry(const struct input_history *history, size_t id) {
+	return &history->entries[id - history->base];
+}
+
+/* Compares the text of the entry id with str, if prefix is set only up to
+ * len. */
+static int
+history_compare(const struct input_history *history, size_t id,
+  const uint32_t *str, size_t len, bool prefix) {
+	const struct input_history_entry *entry = history_entry(history, id);
+	const uint32_t *text = &history->text[entry->offset];
+
+	for (size_t i = 0; i < entry->len && i < len; i++) {
+		if (text[i] != str[i]) {
+			return text[i] < str[i] ? -1 : 1;
+		}
+	}
+
+	if (prefix && entry->len >= len) {
+		return 0;
+	}
+
+	return entry->len < len ? -1 : entry->len > len;
+}
+
+/* Index of the first entry in sorted that is greater than str, or greater or
+ * equal if upper isn't set. */
+static size_t
+history_bound(
+  const struct input_history *history, const uint32_t *str, size_t len,
+  bool upper) {
+	size_t low = 0;
+	size_t high = arrlenu(history->sorted);
+
+	while (low < high) {
+		size_t mid = low + ((high - low) / 2);
+		int cmp = history_compare(history, history->sorted[mid], str, len, false);
+
+		if (cmp < 0 || (upper && cmp == 0)) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+static void
+history_reset(struct input_history *history) {
+	history->ring = history->max;
+	history->base = history->first = history->pos = history->end = 0;
+	arrsetlen(history->entries, 0);
+	arrsetlen(history->sorted, 0);
+	arrsetlen(history->text, 0);
+}
+
+static void
+history_drop_oldest(struct input_history *history) {
+	size_t id = history->base + history->first;
+	const struct input_history_entry *entry = history_entry(history, id);
+	size_t i = history_bound(
+	  history, &history->text[entry->offset], entry->len, false);
+
+	while (history->sorted[i] != id) {
+		i++;
+	}
+
+	arrdel(history->sorted, i);
+	history->first++;
+	history->pos = max_size(history->pos, id + 1);
+}
+
+static enum widget_error
+buf_history_push(struct input *input) {
+	struct input_history *history = &input->history;
+	size_t len = input_len(input);
+
+	if (history->max != history->ring) {
+		history_reset(history);
+	}
+
+	history->pos = history_next_id(history);
+
+	if (len == 0 || len > history->ring) {
+		return WIDGET_NOOP;
+	}
+
+	/* Make the text contiguous. */
+	buf_gap_move(input, len);
+
+	const uint32_t *src = input->buf;
+
+	/* Skip repeats of the newest entry. */
+	if (history->first < arrlenu(history->entries)
+		&& (history_compare(history, history->pos - 1, src, len, false)) == 0) {
+		return WIDGET_NOOP;
+	}
+
+	/* Entries don't wrap around, the oldest ones at the end are dropped
+	 * instead. */
+	if ((history->end + len) > history->ring) {
+		while (history->first < arrlenu(history->entries)
+			   && history->entries[history->first].offset >= history->end) {
+			history_drop_oldest(history);
+		}
+
+		history->end = 0;
+	}
+
+	while (history->first < arrlenu(history->entries)
+		   && history->entries[history->first].offset >= history->end
+		   && history->entries[history->first].offset < (history->end + len)) {
+		history_drop_oldest(history);
+	}
+
+	if ((arrlenu(history->text)) < (history->end + len)) {
+		arrsetlen(history->text,
+		  min_size(max_size(arrlenu(history->text) * 2, history->end + len),
+			history->ring));
+	}
+
+	/* arrins() evaluates the index twice. */
+	size_t sorted_index = history_bound(history, src, len, true);
+
+	memcpy(&history->text[history->end], src, len * sizeof(*src));
+	arrins(history->sorted, sorted_index, history_next_id(history));
+	arrput(history->entries,
+	  ((struct input_history_entry) {.offset = history->end, .len = len}));
+	history->end += len;
+	history->pos = history_next_id(history);
+
+	if (history->first > 0 && (history->first * 2) > arrlenu(history->entries)) {
+		arrdeln(history->entries, 0, history->first);
+		history->base += history->first;
+		history->first = 0;
+	}
+
+	return WIDGET_NOOP;
+}
+
+/* Replaces the text with the entry id, or clears it if id is the next id. */
+static enum widget_error
+history_recall(struct input *input, size_t id, bool keep_cursor) {
+	struct input_history *history = &input->history;
+	size_t cur = input->cur_buf;
+	size_t len = input_len(input);
+
+	input->journal.merge = false;
+	buf_erase(input, 0, len);
+	/* Both edits are undone at once. */
+	input->journal.chain = len > 0;
+
+	if (id < history_next_id(history)) {
+		const struct input_history_entry *entry = history_entry(history, id);
+		buf_insert(input, 0, &history->text[entry->offset], entry->len);
+	}
+
+	input->journal.chain = false;
+	input->cur_buf = keep_cursor ? min_size(cur, input_len(input))
+								 : input_len(input);
+	history->pos = id;
+
+	return WIDGET_REDRAW;
+}
+
+static enum widget_error
+buf_history_step(struct input *input, bool older, bool keep_cursor) {
+	struct input_history *history = &input->history;
+
+	if (history->max != history->ring) {
+		return WIDGET_NOOP;
+	}
+
+	if (older) {
+		if (history->pos <= (history->base + history->first)) {
+			return WIDGET_NOOP;
+		}
+
+		return history_recall(input, history->pos - 1, keep_cursor);
+	}
+
+	if (history->pos >= history_next_id(history)) {
+		return WIDGET_NOOP;
+	}
+
+	return history_recall(input, history->pos + 1, keep_cursor);
+}
+
+static enum widget_error
+buf_history_search(struct input *input) {
+	struct input_history *history = &input->history;
+
+	if (history->max != history->ring) {
+		return WIDGET_NOOP;
+	}
+
+	/* Every entry matches, which would be scanned whole. */
+	if (input->cur_buf == 0) {
+		return buf_history_step(input, true, true);
+	}
+
+	/* Make the text before the cursor contiguous. */
+	buf_gap_move(input, input->cur_buf);
+
+	const uint32_t *query = input->buf;
+	size_t len = input->cur_buf;
+	size_t found = history->pos;
+
+	/* Entries with the prefix are next to each other in sorted. */
+	for (size_t i = history_bound(history, query, len, false);
+		 i < arrlenu(history->sorted)
+		 && (history_compare(history, history->sorted[i], query, len, true))
+			  == 0;
+		 i++) {
+		size_t id = history->sorted[i];
+
+		if (id < history->pos && (found == history->pos || id > found)) {
+			found = id;
+		}
+	}
+
+	if (found == history->pos) {
+		return WIDGET_NOOP;
+	}
+
+	return history_recall(input, found, true);
+}
+
+/* Range of cursor positions on the line at index line. */
+static void
+line_range(struct input *input, size_t line, size_t *first, size_t *last) {
+	struct input_line start = input->layout[line];
+
+	*first = start.start + start.checked;
+	*last = input_len(input);
+
+	if ((line + 1) < arrlenu(input->layout)) {
+		struct input_line next = input->layout[line + 1];
+
+		/* A position right before a wrap is shown on the next line. */
+		*last = next.checked ? next.start : next.start - 1;
+	}
+
+	*last = max_size(*last, *first);
+}
+
+static enum widget_error
+buf_vertical(struct input *input, enum input_event event) {
+	struct widget_points *points = &input->points;
+
+	if (input->scroll_horizontal) {
+		size_t cur = input->cur_buf;
+
+		if (event == INPUT_HOME) {
+			input->cur_buf = 0;
+		} else if (event == INPUT_END) {
+			input->cur_buf = input_len(input);
+		}
+
+		return cur != input->cur_buf ? WIDGET_REDRAW : WIDGET_NOOP;
+	}
+
+	/* Rows are only known after a redraw. */
+	if (!(widget_points_in_bounds(points, points->x1, points->y1))) {
+		return WIDGET_NOOP;
+	}
+
+	layout_prepare(input, points);
+
+	size_t line = layout_cursor_line(input, points);
+	size_t target = line;
+	size_t page = (size_t) (points->y2 - points->y1);
+
+	switch (event) {
+	case INPUT_UP:
+		target = line > 0 ? line - 1 : line;
+		break;
+	case INPUT_DOWN:
+		target = line + 1;
+		break;
+	case INPUT_PAGE_UP:
+		target = line > page ? line - page : 0;
+		break;
+	case INPUT_PAGE_DOWN:
+		target = line + page;
+		break;
+	default:
+		break;
+	}
+
+	while (arrlenu(input->layout) <= (target + 1)
+		   && (layout_next(input, points))) {}
+
+	target = min_size(target, arrlenu(input->layout) - 1);
+
+	size_t first = 0;
+	size_t last = 0;
+	size_t cur = input->cur_buf;
+
+	line_range(input, target, &first, &last);
+
+	if (event == INPUT_HOME) {
+		input->cur_buf = first;
+	} else if (event == INPUT_END) {
+		input->cur_buf = last;
+	} else if (target != line) {
+		if (input->goal_x < 0) {
+			struct input_line start = input->layout[line];
+			line_walk(input, points, &start, cur, &input->goal_x, 0, false);
+		}
+
+		struct input_line start = input->layout[target];
+		int x = 0;
+
+		line_walk(input, points, &start, first, &x, 0, false);
+
+		for (input->cur_buf = first; input->cur_buf < last;
+			 input->cur_buf++) {
+			int width = buf_width(input, input->cur_buf);
+
+			if ((x + width) > input->goal_x) {
+				break;
+			}
+
+			x += width;
+		}
+	}
+
+	return cur != input->cur_buf ? WIDGET_REDRAW : WIDGET_NOOP;
+}
+
+static enum widget_error
+input_handle_event_va(
+  struct input *input, enum input_event event, va_list vl) {
+	if (!input) {
+		return WIDGET_NOOP;
+	}
+
+	if (event != INPUT_UP && event != INPUT_DOWN && event != INPUT_PAGE_UP
+		&& event != INPUT_PAGE_DOWN) {
+		input->goal_x = -1;
+	}
+
+	/* Only typing and erasing in a row are undone together. */
+	if (event != INPUT_ADD && event != INPUT_DELETE) {
+		input->journal.merge = false;
+	}
+
+	/* Editing the text starts the history over from the newest entry. */
+	if (event == INPUT_CLEAR || event == INPUT_DELETE
+		|| event == INPUT_DELETE_WORD || event == INPUT_UNDO
+		|| event == INPUT_REDO || event >= INPUT_ADD) {
+		input->history.pos = history_next_id(&input->history);
+	}
+
+	switch (event) {
+	case INPUT_CLEAR:
+		if ((input_len(input)) == 0) {
+			return WIDGET_NOOP;
+		}
+
+		buf_erase(input, 0, input_len(input));
+		input->cur_buf = 0;
+		return WIDGET_REDRAW;
+	case INPUT_DELETE:
+		return buf_del(input);
+	case INPUT_DELETE_WORD:
+		return buf_delword(input);
+	case INPUT_RIGHT:
+		return buf_right(input);
+	case INPUT_RIGHT_WORD:
+		return buf_rightword(input);
+	case INPUT_LEFT:
+		return buf_left(input);
+	case INPUT_LEFT_WORD:
+		return buf_leftword(input);
+	case INPUT_UP:
+	case INPUT_DOWN:
+	case INPUT_HOME:
+	case INPUT_END:
+	case INPUT_PAGE_UP:
+	case INPUT_PAGE_DOWN:
+		return buf_vertical(input, event);
+	case INPUT_UNDO:
+		return buf_undo(input);
+	case INPUT_REDO:
+		return buf_redo(input);
+	case INPUT_HISTORY_PUSH:
+		return buf_history_push(input);
+	case INPUT_HISTORY_PREV:
+		return buf_history_step(input, true, false);
+	case INPUT_HISTORY_NEXT:
+		return buf_history_step(input, false, false);
+	case INPUT_HISTORY_SEARCH:
+		return buf_history_search(input);
+	case INPUT_ADD:
+		{
+			/* https://bugs.llvm.org/show_bug.cgi?id=41311
+			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
+			uint32_t ch = va_arg(vl, uint32_t);
+
+			return buf_add(input, ch);
+		}
+	case INPUT_ADD_STR:
+		{
+			const char *str = va_arg(vl, const char *);
+			size_t size = va_arg(vl, size_t);
+
+			return buf_add_str(input, str, size);
+		}
+	case INPUT_ADD_UTF32:
+		{
+			const uint32_t *str = va_arg(vl, const uint32_t *);
+			size_t len = va_arg(vl, size_t);
+
+			return buf_add_utf32(input, str, len);
+		}
+	default:
+		assert(0);
+	}
+
+	return WIDGET_NOOP;
+}
+
+enum widget_error
+input_handle_event(struct input *input, enum input_event event, ...) {
+	va_list vl = {0};
+	va_start(vl, event);
+	enum widget_error ret = input_handle_event_va(input, event, vl);
+	va_end(vl);
+
+	return ret;
+}
+
+/* The bounding box of the rows between y1 and y2, inclusive. */
+static struct widget_points
+damage_rows(const struct widget_points *points, int y1, int y2) {
+	return (struct widget_points) {.x1 = points->x1,
+	  .x2 = points->x2,
+	  .y1 = max(min(y1, y2), points->y1),
+	  .y2 = min(max(y1, y2) + 1, points->y2)};
+}
+
+enum widget_error
+input_handle_event_damage(struct input *input, struct widget_points *damage,
+  enum input_event event, ...) {
+	va_list vl = {0};
+	va_start(vl, event);
+	enum widget_error ret = input_handle_event_va(input, event, vl);
+	va_end(vl);
+
+	if (!damage) {
+		return ret;
+	}
+
+	*damage = (struct widget_points) {0};
+
+	if (ret != WIDGET_REDRAW
+		|| !(widget_points_in_bounds(
+		  &input->points, input->points.x1, input->points.y1))) {
+		return ret;
+	}
+
+	struct input old = *input;
+	struct widget_points points = input->points;
+	int rows = 0;
+
+	if (input->scroll_horizontal) {
+		*damage = damage_rows(&points, points.y1, points.y1);
+		return ret;
+	}
+
+	/* Lay out the input as the next redraw would. */
+	input_redraw(input, &points, &rows, true);
+
+	if (rows != old.rows || input->start_y != old.start_y) {
+		*damage = points;
+		return ret;
+	}
+
+	switch (event) {
+	case INPUT_RIGHT:
+	case INPUT_RIGHT_WORD:
+	case INPUT_LEFT:
+	case INPUT_LEFT_WORD:
+	case INPUT_UP:
+	case INPUT_DOWN:
+	case INPUT_HOME:
+	case INPUT_END:
+	case INPUT_PAGE_UP:
+	case INPUT_PAGE_DOWN:
+		/* Only the cursor moved. */
+		*damage = (struct widget_points) {
+		  .x1 = min(old.cur_x, input->cur_x),
+		  .x2 = min(max(old.cur_x, input->cur_x) + 1, points.x2),
+		  .y1 = min(old.cur_y, input->cur_y),
+		  .y2 = max(old.cur_y, input->cur_y) + 1,
+		};
+
+		if (old.cur_y != input->cur_y) {
+			*damage = damage_rows(&points, old.cur_y, input->cur_y);
+		}
+		break;
+	case INPUT_UNDO:
+	case INPUT_REDO:
+	case INPUT_HISTORY_PREV:
+	case INPUT_HISTORY_NEXT:
+	case INPUT_HISTORY_SEARCH:
+		/* The edit could have been anywhere. */
+		*damage = points;
+		break;
+	default:
+		/* Text after the cursor might have been wrapped differently. */
+		*damage = damage_rows(
+		  &points, min(old.cur_y, input->cur_y), points.y2 - 1);
+		break;
+	}
+
+	return ret;
+}
+
+char *
+input_buf(struct input *input) {
+	size_t size = input_buf_into(input, NULL, 0);
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	char *buf = WIDGETS_MALLOC((size + 1) * sizeof(*buf));
+
+	if (!buf) {
+		return NULL;
+	}
+
+	input_buf_into(input, buf, size + 1);
+
+	return buf;
+}
+
+size_t
+input_buf_into(const struct input *input, char *dst, size_t size) {
+	if (!input) {
+		return 0;
+	}
+
+	if (dst && size > 0) {
+		size_t written = 0;
+
+		for (size_t i = 0, len = input_len(input); i < len; i++) {
+			uint32_t uc = buf_at(input, i);
+
+			/* Leave space for the NUL. */
+			if ((written + (uc_utf8_len(uc))) >= size) {
+				break;
+			}
+
+			if (uc < 0x80) {
+				dst[written++] = (char) uc;
+			} else {
+				written += (size_t) tb_utf8_unicode_to_char(&dst[written], uc);
+			}
+		}
+
+		dst[written] = '\0';
+	}
+
+	return input->utf8_len;
+}
+
+/* Calls visit on every node in the subtree of node, children first. The tree
+ * is walked through the parent pointers and indices of the nodes instead of
+ * recursing so that deep trees can't overflow the stack. */
+static void
+subtree_visit(struct treeview_node *node,
+  void (*visit)(struct treeview_node *node, void *ctx), void *ctx) {
+	struct treeview_node *current = node;
+	size_t i = 0; /* Next child of current to visit. */
+
+	for (;;) {
+		if (i < arrlenu(current->nodes)) {
+			current = current->nodes[i];
+			i = 0;
+			continue;
+		}
+
+		/* Read before visit as it might free the node. */
+		struct treeview_node *parent = current->parent;
+		size_t next = current->index + 1;
+		bool is_done = (current == node);
+
+		visit(current, ctx);
+
+		if (is_done) {
+			break;
+		}
+
+		current = parent;
+		i = next;
+	}
+}
+
+enum { TREEVIEW_SLAB = 1024 }; /* Nodes in each slab of a pool. */
+
+/* Rows taken by the node along with it's visible children. */
+static size_t
+node_rows(const struct treeview_node *node) {
+	return node->is_hidden ? 0 : 1 + (node->is_expanded ? node->visible : 0);
+}
+
+/* Drops the offsets of the children of parent from index onwards. */
+static void
+offsets_invalidate(struct treeview_node *parent, size_t index) {
+	parent->offsets_valid = min_size(parent->offsets_valid, index);
+}
+
+/* Computes the offsets of the children of parent up to index. */
+static void
+offsets_update(struct treeview_node *parent, size_t index) {
+	for (size_t i = parent->offsets_valid; i <= index; i++) {
+		struct treeview_node *prev = i > 0 ? parent->nodes[i - 1] : NULL;
+
+		parent->nodes[i]->offset = prev ? prev->offset + node_rows(prev) : 0;
+	}
+
+	parent->offsets_valid = max_size(parent->offsets_valid, index + 1);
+}
+
+/* Updates the visible rows of parent and it's parents after the rows taken by
+ * one of it's children changed, stopping at the first collapsed or hidden one.
+ * The offsets of the children of parent have to be dropped by the caller. */
+static void
+parents_rows_update(
+  struct treeview_node *parent, size_t added, size_t removed) {
+	for (; parent; parent = parent->parent) {
+		assert(parent->visible + added >= removed);
+		parent->visible = parent->visible + added - removed;
+
+		if (!parent->is_expanded || parent->is_hidden) {
+			break;
+		}
+
+		if (parent->parent) {
+			offsets_invalidate(parent->parent, parent->index + 1);
+		}
+	}
+}
+
+/* Row of the node counting from the root, which takes the first one. */
+static int
+node_height_bottom_to_up(struct treeview_node *node) {
+	assert(node);
+
+	size_t height = 1;
+
+	for (; node->parent; node = node->parent) {
+		assert(node->parent->is_expanded);
+
+		offsets_update(node->parent, node->index);
+		height += node->offset + 1;
+	}
+
+	return (int) height;
+}
+
+/* The child of parent taking the given row of it's children, which must be
+ * below the parent's visible rows. Hidden children take no rows so the last
+ * child starting at or before the row is the one. */
+static struct treeview_node *
+child_at_row(struct treeview_node *parent, size_t row) {
+	struct treeview_node **nodes = parent->nodes;
+	size_t len = arrlenu(nodes);
+
+	assert(row < parent->visible);
+
+	/* The offsets are only computed as far as the row. */
+	while (parent->offsets_valid < len
+		   && (parent->offsets_valid == 0
+			   || (nodes[parent->offsets_valid - 1]->offset
+					+ node_rows(nodes[parent->offsets_valid - 1]))
+					<= row)) {
+		offsets_update(parent, parent->offsets_valid);
+	}
+
+	size_t lo = 0;
+	size_t hi = parent->offsets_valid;
+
+	while ((hi - lo) > 1) {
+		size_t mid = lo + ((hi - lo) / 2);
+
+		if (nodes[mid]->offset <= row) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return nodes[lo];
+}
+
+/* The first child of node which isn't hidden, NULL if there's none. */
+static struct treeview_node *
+child_first(struct treeview_node *node) {
+	if ((arrlenu(node->nodes)) > 0 && !node->nodes[0]->is_hidden) {
+		return node->nodes[0];
+	}
+
+	return node->visible > 0 ? child_at_row(node, 0) : NULL;
+}
+
+/* The last child of node which isn't hidden, NULL if there's none. */
+static struct treeview_node *
+child_last(struct treeview_node *node) {
+	if ((arrlenu(node->nodes)) > 0 && !arrlast(node->nodes)->is_hidden) {
+		return arrlast(node->nodes);
+	}
+
+	return node->visible > 0 ? child_at_row(node, node->visible - 1) : NULL;
+}
+
+/* The next sibling of node which isn't hidden, NULL if there's none. */
+static struct treeview_node *
+sibling_next(struct treeview_node *node) {
+	struct treeview_node *parent = node->parent;
+	size_t next = node->index + 1;
+
+	if (next == arrlenu(parent->nodes)) {
+		return NULL;
+	}
+
+	if (!parent->nodes[next]->is_hidden) {
+		return parent->nodes[next];
+	}
+
+	offsets_update(parent, node->index);
+	size_t row = node->offset + node_rows(node);
+
+	return row < parent->visible ? child_at_row(parent, row) : NULL;
+}
+
+/* The previous sibling of node which isn't hidden, NULL if there's none. */
+static struct treeview_node *
+sibling_prev(struct treeview_node *node) {
+	struct treeview_node *parent = node->parent;
+
+	if (node->index == 0) {
+		return NULL;
+	}
+
+	if (!parent->nodes[node->index - 1]->is_hidden) {
+		return parent->nodes[node->index - 1];
+	}
+
+	offsets_update(parent, node->index);
+
+	return node->offset > 0 ? child_at_row(parent, node->offset - 1) : NULL;
+}
+
+/* The last visible node in the subtree of node. */
+static struct treeview_node *
+leaf(struct treeview_node *node) {
+	struct treeview_node *child = NULL;
+
+	while (node->is_expanded && (child = child_last(node))) {
+		node = child;
+	}
+
+	return node;
+}
+
+/* The next visible node after node and it's children, NULL if there's none. */
+static struct treeview_node *
+node_next(struct treeview_node *node) {
+	for (; node->parent; node = node->parent) {
+		struct treeview_node *next = sibling_next(node);
+
+		if (next) {
+			return next;
+		}
+	}
+
+	return NULL;
+}
+
+/* Whether neither node nor one of it's parents is hidden. */
+static bool
+node_is_shown(const struct treeview_node *node) {
+	for (; node; node = node->parent) {
+		if (node->is_hidden) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Fills walk with the path to the node at row, counting from 0 for the first
+ * visible node. Returns false if there's no such row. */
+static bool
+walk_seek(struct treeview *treeview, size_t row) {
+	struct treeview_node *parent = &treeview->root;
+
+	arrsetlen(treeview->walk, 0);
+
+	if (row >= parent->visible) {
+		return false;
+	}
+
+	for (;;) {
+		struct treeview_node *node = child_at_row(parent, row);
+
+		row -= node->offset;
+		arrput(treeview->walk, ((struct treeview_walk) {parent, node->index}));
+
+		if (row == 0) {
+			return true;
+		}
+
+		/* Within the rows of it's children. */
+		row--;
+		parent = node;
+	}
+}
+
+/* Moves walk to the next visible node. Returns false after the last one. */
+static bool
+walk_next(struct treeview *treeview) {
+	struct treeview_walk top = arrlast(treeview->walk);
+	struct treeview_node *node = top.parent->nodes[top.index];
+	struct treeview_node *child = node->is_expanded ? child_first(node) : NULL;
+
+	if (child) {
+		arrput(treeview->walk, ((struct treeview_walk) {node, child->index}));
+		return true;
+	}
+
+	while ((arrlenu(treeview->walk)) > 0) {
+		struct treeview_walk *level = &arrlast(treeview->walk);
+		struct treeview_node *next
+		  = sibling_next(level->parent->nodes[level->index]);
+
+		if (next) {
+			level->index = next->index;
+			return true;
+		}
+
+		(void) arrpop(treeview->walk);
+	}
+
+	return false;
+}
+
+/* Draws the node walk points to on row y. */
+static void
+walk_draw(
+  struct treeview *treeview, const struct widget_points *points, int y) {
+	/* Stolen from tview's semigraphics. */
+	const char symbol[] = "├──";
+	const char symbol_end[] = "└──";
+	const char symbol_continued[] = "│";
+	const int gap_size = 3; /* Width of the above symbols (first 3). */
+
+	size_t depth = arrlenu(treeview->walk);
+	int x = points->x1;
+
+	/* Top level nodes are drawn without any symbols. */
+	for (size_t i = 1; i < depth && x < points->x2; i++) {
+		const struct treeview_walk *level = &treeview->walk[i];
+		bool is_end = !sibling_next(level->parent->nodes[level->index]);
+
+		if (i == (depth - 1)) {
+			widget_print_str(x, y, points->x2, TB_DEFAULT, TB_DEFAULT,
+			  (is_end ? symbol_end : symbol));
+		} else if (!is_end) {
+			/* The parent-child relation of the levels above. */
+			widget_print_str(
+			  x, y, points->x2, TB_DEFAULT, TB_DEFAULT, symbol_continued);
+		}
+
+		x += gap_size;
+	}
+
+	if (x < points->x2) {
+		const struct treeview_walk *level = &arrlast(treeview->walk);
+		const struct treeview_node *node = level->parent->nodes[level->index];
+		struct widget_points user_points = {0};
+
+		widget_points_set(&user_points, x, points->x2, y, points->y2);
+		node->draw_cb(node->data, &user_points, (node == treeview->selected));
+	}
+}
+
+int
+treeview_node_init(
+  struct treeview_node *node, void *data, treeview_draw_cb draw_cb) {
+	if (!node || !draw_cb) {
+		return -1;
+	}
+
+	*node = (struct treeview_node) {
+	  .is_expanded = true, .data = data, .draw_cb = draw_cb};
+
+	return 0;
+}
+
+struct treeview_node *
+treeview_node_alloc(void *data, treeview_draw_cb draw_cb) {
+	struct treeview_node *node = draw_cb ? WIDGETS_MALLOC(sizeof(*node)) : NULL;
+
+	if (node) {
+		treeview_node_init(node, data, draw_cb);
+	}
+
+	return node;
+}
+
+struct treeview_node *
+treeview_pool_alloc(
+  struct treeview *treeview, void *data, treeview_draw_cb draw_cb) {
+	if (!treeview || !draw_cb) {
+		return NULL;
+	}
+
+	struct treeview_pool *pool = &treeview->pool;
+	struct treeview_node *node = pool->free;
+
+	if (node) {
+		pool->free = node->parent;
+	} else {
+		if (!pool->slabs || pool->used == TREEVIEW_SLAB) {
+			struct treeview_node *slab
+			  = WIDGETS_MALLOC(TREEVIEW_SLAB * sizeof(*slab));
+
+			if (!slab) {
+				return NULL;
+			}
+
+			arrput(pool->slabs, slab);
+			pool->used = 0;
+		}
+
+		node = &arrlast(pool->slabs)[pool->used++];
+	}
+
+	treeview_node_init(node, data, draw_cb);
+	node->pool = pool;
+
+	return node;
+}
+
+/* Index of the first child of parent that is greater than node, or greater or
+ * equal if upper isn't set. */
+static size_t
+children_bound(const struct treeview_node *parent,
+  const struct treeview_node *node, bool upper) {
+	size_t low = 0;
+	size_t high = arrlenu(parent->nodes);
+
+	while (low < high) {
+		size_t mid = low + ((high - low) / 2);
+		int cmp = parent->compare_cb(parent->nodes[mid], node);
+
+		if (cmp < 0 || (upper && cmp == 0)) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+/* Sets the index of the children of parent from start on. */
+static void
+children_reindex(struct treeview_node *parent, size_t start) {
+	for (size_t i = start, len = arrlenu(parent->nodes); i < len; i++) {
+		parent->nodes[i]->index = i;
+	}
+}
+
+/* Sorts the children of parent from start on, then merges them into the ones
+ * before which are already sorted. Children comparing equal keep their order.
+ * Only the children after the first one that moved are reindexed. */
+static void
+children_sort(struct treeview_node *parent, size_t start) {
+	struct treeview_node **nodes = parent->nodes;
+	size_t len = arrlenu(nodes);
+	size_t i = start + 1;
+
+	while (i < len && parent->compare_cb(nodes[i - 1], nodes[i]) <= 0) {
+		i++;
+	}
+
+	bool is_sorted = i >= len; /* Whether the added children are. */
+
+	if (start == len
+		|| (is_sorted
+			&& (start == 0
+				|| parent->compare_cb(nodes[start - 1], nodes[start]) <= 0))) {
+		return;
+	}
+
+	size_t added = len - start;
+	struct treeview_node **tmp = NULL;
+
+	arrsetlen(tmp, added * 2);
+	memcpy(tmp, &nodes[start], added * sizeof(*tmp));
+
+	/* Bottom-up merge sort, between both halves of tmp. */
+	struct treeview_node **src = tmp;
+	struct treeview_node **dst = &tmp[added];
+
+	for (size_t width = 1; !is_sorted && width < added; width *= 2) {
+		for (size_t low = 0; low < added; low += width * 2) {
+			size_t mid = min_size(low + width, added);
+			size_t high = min_size(low + (width * 2), added);
+			size_t l = low;
+			size_t r = mid;
+
+			for (size_t k = low; k < high; k++) {
+				bool left = l < mid
+							&& (r == high
+								|| parent->compare_cb(src[l], src[r]) <= 0);
+
+				dst[k] = left ? src[l++] : src[r++];
+			}
+		}
+
+		struct treeview_node **swap = src;
+
+		src = dst;
+		dst = swap;
+	}
+
+	/* Merged from the back so the children before only move if needed. */
+	size_t old = start;
+
+	for (size_t k = len, run = added; run > 0;) {
+		if (old > 0 && parent->compare_cb(nodes[old - 1], src[run - 1]) > 0) {
+			nodes[--k] = nodes[--old];
+		} else {
+			nodes[--k] = src[--run];
+		}
+
+		nodes[k]->index = k;
+	}
+
+	offsets_invalidate(parent, old);
+	arrfree(tmp);
+}
+
+/* Links child into the nodes of parent, at it's position if they are sorted.
+ * The rows of the parents have to be updated by the caller. */
+static void
+child_link(struct treeview_node *parent, struct treeview_node *child) {
+	child->parent = parent;
+
+	if (!child->compare_cb) {
+		child->compare_cb = parent->compare_cb;
+	}
+
+	if (parent->compare_cb) {
+		/* After the children comparing equal, so they stay in the order they
+		 * were added. arrins() evaluates the index twice. */
+		size_t index = children_bound(parent, child, true);
+
+		arrins(parent->nodes, index, child);
+		children_reindex(parent, index);
+		offsets_invalidate(parent, index);
+	} else {
+		child->index = arrlenu(parent->nodes);
+		arrput(parent->nodes, child);
+	}
+}
+
+int
+treeview_node_add_child(
+  struct treeview_node *parent, struct treeview_node *child) {
+	if (!parent || !child || parent == child) {
+		return -1;
+	}
+
+	child_link(parent, child);
+	parents_rows_update(parent, node_rows(child), 0);
+
+	return 0;
+}
+
+struct treeview_node *
+treeview_node_find(
+  const struct treeview_node *parent, const struct treeview_node *node) {
+	if (!parent || !node || !parent->compare_cb) {
+		return NULL;
+	}
+
+	size_t index = children_bound(parent, node, false);
+
+	if (index < arrlenu(parent->nodes)
+		&& parent->compare_cb(parent->nodes[index], node) == 0) {
+		return parent->nodes[index];
+	}
+
+	return NULL;
+}
+
+static void
+node_free(struct treeview_node *node, void *ctx) {
+	(void) ctx;
+	arrfree(node->nodes);
+
+	if (node->pool) {
+		/* Kept for reuse until the whole pool is freed. */
+		node->parent = node->pool->free;
+		node->pool->free = node;
+	} else {
+		WIDGETS_FREE(node);
+	}
+}
+
+static void
+node_clear(struct treeview_node *node, void *ctx) {
+	(void) ctx;
+	arrfree(node->nodes);
+	memset(node, 0, sizeof(*node));
+}
+
+static void
+node_children_destroy(struct treeview_node *node) {
+	for (size_t i = 0, len = arrlenu(node->nodes); i < len; i++) {
+		subtree_visit(node->nodes[i], node_free, NULL);
+	}
+
+	arrfree(node->nodes);
+}
+
+void
+treeview_node_destroy(struct treeview_node *node) {
+	if (node) {
+		subtree_visit(node, node_free, NULL);
+	}
+}
+
+void
+treeview_node_finish(struct treeview_node *node) {
+	if (node) {
+		subtree_visit(node, node_clear, NULL);
+	}
+}
+
+static char
+ascii_lower(char c) {
+	return (c >= 'A' && c <= 'Z') ? (char) (c - 'A' + 'a') : c;
+}
+
+/* Whether key contains the first len bytes of query, ignoring ASCII case. */
+static bool
+key_match(const char *key, const char *query, size_t len) {
+	if (!key) {
+		return false;
+	}
+
+	for (; *key; key++) {
+		size_t i = 0;
+
+		while (i < len && key[i]
+			   && ascii_lower(key[i]) == ascii_lower(query[i])) {
+			i++;
+		}
+
+		if (i == len) {
+			return true;
+		}
+	}
+
+	return len == 0;
+}
+
+struct filter_ctx {
+	const char *query;
+	size_t len; /* 0 if there's no filter. */
+	struct treeview_node ***matches;
+};
+
+/* Matches node against the query, it's children have to be done before. */
+static void
+node_filter(struct treeview_node *node, void *ctx) {
+	struct filter_ctx *filter = ctx;
+
+	node->is_matched = filter->len > 0
+					   && key_match(node->key, filter->query, filter->len);
+	node->matched = node->is_matched;
+	node->visible = 0;
+	node->offsets_valid = 0;
+
+	for (size_t i = 0, len = arrlenu(node->nodes); i < len; i++) {
+		node->matched += node->nodes[i]->matched > 0;
+		node->visible += node_rows(node->nodes[i]);
+	}
+
+	node->is_hidden = node->parent && filter->len > 0 && node->matched == 0;
+
+	if (node->is_matched) {
+		arrput(*filter->matches, node);
+	}
+}
+
+/* Adds change to the matched of node and updates it's visible rows after the
+ * rows taken by one of it's children went from removed to added, then does the
+ * same for it's parents, showing or hiding them on the way. Stops at the first
+ * parent whose rows and matches stay the same. Only valid while the filter has
+ * levels as the matched counts might be stale otherwise. The offsets of the
+ * children of node have to be dropped by the caller. */
+static void
+parents_matches_update(
+  struct treeview_node *node, int change, size_t added, size_t removed) {
+	while (node) {
+		bool had_matches = node->matched > 0;
+		size_t rows = node_rows(node);
+
+		if (change > 0) {
+			node->matched++;
+		} else if (change < 0) {
+			node->matched--;
+		}
+
+		assert(node->visible + added >= removed);
+		node->visible = node->visible + added - removed;
+		node->is_hidden = node->parent && node->matched == 0;
+
+		change = (node->matched > 0) == had_matches ? 0 : had_matches ? -1 : 1;
+		added = node_rows(node);
+		removed = rows;
+
+		if (change == 0 && added == removed) {
+			break;
+		}
+
+		if (node->parent && added != removed) {
+			offsets_invalidate(node->parent, node->index + 1);
+		}
+
+		node = node->parent;
+	}
+}
+
+/* Changes whether node matches, showing or hiding it and the parents which
+ * have no other match on the way up. Matches should be added children first and
+ * removed parents first, so that the parents are only updated once. */
+static void
+node_match_set(struct treeview_node *node, bool is_matched) {
+	node->is_matched = is_matched;
+	parents_matches_update(node, is_matched ? 1 : -1, 0, 0);
+}
+
+/* Moves the selection to it's closest parent which is visible if it isn't, or
+ * to the first row if there's none. */
+static void
+selected_show(struct treeview *treeview) {
+	struct treeview_node *selected = treeview->selected;
+
+	for (struct treeview_node *node = treeview->selected; node && node->parent;
+		 node = node->parent) {
+		if (node->is_hidden) {
+			selected = node->parent;
+		} else if (node != treeview->selected && !node->is_expanded) {
+			selected = node;
+		}
+	}
+
+	if (!selected || !selected->parent) {
+		selected = child_first(&treeview->root);
+	}
+
+	treeview->selected = selected;
+}
+
+/* Forgets the matches kept for the next query, which is then matched against
+ * every node. Done when the nodes change as the matches might be freed. */
+static void
+filter_levels_drop(struct treeview *treeview) {
+	arrsetlen(treeview->filter.matches, 0);
+	arrsetlen(treeview->filter.ends, 0);
+}
+
+int
+treeview_filter(struct treeview *treeview, const char *query) {
+	if (!treeview) {
+		return -1;
+	}
+
+	struct treeview_filter *filter = &treeview->filter;
+	size_t len = query ? strlen(query) : 0;
+	size_t old_len = filter->query ? strlen(filter->query) : 0;
+	/* Length of the part shared with the last query, which is only matched
+	 * again when it's the whole of both. */
+	size_t common = 0;
+
+	if (len == 0 && old_len == 0) {
+		return 0;
+	}
+
+	while (common < len && common < old_len
+		   && (ascii_lower(query[common])
+				== ascii_lower(filter->query[common]))) {
+		common++;
+	}
+
+	if ((arrlenu(filter->ends)) == 0 || common < filter->base
+		|| (common == len && common == old_len)) {
+		struct filter_ctx ctx = {query, len, &filter->matches};
+
+		filter_levels_drop(treeview);
+		subtree_visit(&treeview->root, node_filter, &ctx);
+		filter->base = len;
+
+		if (len > 0) {
+			arrput(filter->ends, arrlenu(filter->matches));
+		}
+	} else {
+		/* Matches dropped by the levels above the shared part match again. */
+		while ((arrlenu(filter->ends)) > (common - filter->base + 1)) {
+			(void) arrpop(filter->ends);
+
+			size_t levels = arrlenu(filter->ends);
+			size_t start = levels > 1 ? filter->ends[levels - 2] : 0;
+
+			for (size_t i = start; i < arrlast(filter->ends); i++) {
+				if (!filter->matches[i]->is_matched) {
+					node_match_set(filter->matches[i], true);
+				}
+			}
+
+			arrsetlen(filter->matches, arrlast(filter->ends));
+		}
+
+		/* Every added character only tests the matches of the level before.
+		 * These are in post-order, so they are walked backwards to have the
+		 * parents first and the new level is turned around after. */
+		for (size_t n = common + 1; n <= len; n++) {
+			size_t levels = arrlenu(filter->ends);
+			size_t start = levels > 1 ? filter->ends[levels - 2] : 0;
+			size_t end = arrlast(filter->ends);
+
+			for (size_t i = end; i > start; i--) {
+				struct treeview_node *node = filter->matches[i - 1];
+
+				if (key_match(node->key, query, n)) {
+					arrput(filter->matches, node);
+				} else {
+					node_match_set(node, false);
+				}
+			}
+
+			for (size_t i = end, j = arrlenu(filter->matches); (i + 1) < j;
+				 i++, j--) {
+				struct treeview_node *node = filter->matches[i];
+
+				filter->matches[i] = filter->matches[j - 1];
+				filter->matches[j - 1] = node;
+			}
+
+			arrput(filter->ends, arrlenu(filter->matches));
+		}
+	}
+
+	arrsetlen(filter->query, len + 1);
+	memcpy(filter->query, query ? query : "", len + 1);
+	treeview->start_y = 0;
+	selected_show(treeview);
+
+	return 0;
+}
+
+int
+treeview_init(struct treeview *treeview) {
+	if (!treeview) {
+		return -1;
+	}
+
+	*treeview = (struct treeview) {
+	  .root = {
+	  	.is_expanded = true,
+	  },
+	};
+
+	return 0;
+}
+
+int
+treeview_node_evict(struct treeview *treeview, struct treeview_node *node) {
+	if (!treeview || !node || node->is_expanded || !node->populate_cb) {
+		return -1;
+	}
+
+	for (struct treeview_node *parent = treeview->selected; parent;
+		 parent = parent->parent) {
+		if (parent->parent == node) {
+			return -1;
+		}
+	}
+
+	/* Collapsed, so the parents' rows don't change. */
+	node_children_destroy(node);
+	node->visible = 0;
+	node->offsets_valid = 0;
+	node->is_populated = false;
+	filter_levels_drop(treeview);
+
+	return 0;
+}
+
+int
+treeview_node_reparent(struct treeview *treeview, struct treeview_node *node,
+  struct treeview_node *parent) {
+	if (!treeview || !node || !node->parent) {
+		return -1;
+	}
+
+	if (!parent) {
+		parent = &treeview->root;
+	}
+
+	for (struct treeview_node *up = parent; up; up = up->parent) {
+		if (up == node) {
+			return -1;
+		}
+	}
+
+	/* The matched counts are only kept while the filter has levels, which
+	 * stay valid as no node is freed. */
+	bool has_matches = (arrlenu(treeview->filter.ends)) > 0;
+	int change = has_matches && node->matched > 0 ? 1 : 0;
+	struct treeview_node *old = node->parent;
+	size_t index = node->index;
+	size_t rows = node_rows(node);
+
+	arrdel(old->nodes, index);
+	children_reindex(old, index);
+	offsets_invalidate(old, index);
+
+	if (has_matches) {
+		parents_matches_update(old, -change, 0, rows);
+	} else {
+		parents_rows_update(old, 0, rows);
+	}
+
+	child_link(parent, node);
+
+	if (has_matches) {
+		parents_matches_update(parent, change, rows, 0);
+	} else {
+		parents_rows_update(parent, rows, 0);
+	}
+
+	selected_show(treeview);
+
+	return 0;
+}
+
+int
+treeview_build(struct treeview *treeview, struct treeview_node *parent,
+  const struct treeview_record *records, size_t len) {
+	if (!treeview || (len > 0 && !records)) {
+		return -1;
+	}
+
+	if (!parent) {
+		parent = &treeview->root;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		size_t max_depth = i > 0 ? records[i - 1].depth + 1 : 0;
+
+		if (!records[i].draw_cb || records[i].depth > max_depth) {
+			return -1;
+		}
+	}
+
+	size_t *counts = NULL; /* Number of children of each record. */
+	size_t *path = NULL;   /* Records on the path to the current one. */
+	size_t top_len = 0;
+
+	arrsetlen(counts, len);
+
+	for (size_t i = 0; i < len; i++) {
+		size_t depth = records[i].depth;
+
+		counts[i] = 0;
+		arrsetlen(path, depth);
+
+		if (depth > 0) {
+			counts[path[depth - 1]]++;
+		} else {
+			top_len++;
+		}
+
+		arrput(path, i);
+	}
+
+	arrfree(path);
+	arrsetcap(parent->nodes, arrlenu(parent->nodes) + top_len);
+
+	struct treeview_node **nodes = NULL; /* Nodes on the current path. */
+	size_t start = arrlenu(parent->nodes);
+	size_t rows = 0; /* Rows added to parent. */
+	int ret = 0;
+
+	for (size_t i = 0; i <= len; i++) {
+		size_t depth = i < len ? records[i].depth : 0;
+
+		/* The subtrees that ended are complete, so their rows are known. */
+		while ((arrlenu(nodes)) > depth) {
+			struct treeview_node *node = arrpop(nodes);
+
+			if (node->compare_cb) {
+				children_sort(node, 0);
+			}
+
+			if (node->parent == parent) {
+				rows += node_rows(node);
+			} else {
+				node->parent->visible += node_rows(node);
+			}
+		}
+
+		if (i == len || ret == -1) {
+			continue;
+		}
+
+		struct treeview_node *node
+		  = treeview_pool_alloc(treeview, records[i].data, records[i].draw_cb);
+
+		if (!node) {
+			/* Keep what was built so far consistent. */
+			ret = -1;
+			continue;
+		}
+
+		if (counts[i] > 0) {
+			arrsetcap(node->nodes, counts[i]);
+		}
+
+		node->key = records[i].key;
+		node->parent = depth > 0 ? nodes[depth - 1] : parent;
+		node->compare_cb = node->parent->compare_cb;
+		node->index = arrlenu(node->parent->nodes);
+		arrput(node->parent->nodes, node);
+		arrput(nodes, node);
+	}
+
+	arrfree(nodes);
+	arrfree(counts);
+
+	if (parent->compare_cb) {
+		children_sort(parent, start);
+	}
+
+	parents_rows_update(parent, rows, 0);
+	filter_levels_drop(treeview);
+
+	if (!treeview->selected && parent == &treeview->root) {
+		treeview->selected = child_first(parent);
+	}
+
+	return ret;
+}
+
+/* Frees the children of node that aren't from the pool along with it's nodes
+ * array. */
+static void
+node_unpooled_destroy(struct treeview_node *node) {
+	for (size_t i = 0, len = arrlenu(node->nodes); i < len; i++) {
+		if (!node->nodes[i]->pool) {
+			treeview_node_destroy(node->nodes[i]);
+		}
+	}
+
+	arrfree(node->nodes);
+}
+
+void
+treeview_finish(struct treeview *treeview) {
+	if (treeview) {
+		struct treeview_pool *pool = &treeview->pool;
+		size_t slabs = arrlenu(pool->slabs);
+
+		/* Pooled nodes are visited in memory order instead of walking the
+		 * tree, nodes allocated alone can only be found from their parents.
+		 * The slabs are freed afterwards as these might have pooled nodes. */
+		node_unpooled_destroy(&treeview->root);
+
+		for (size_t i = 0; i < slabs; i++) {
+			size_t used = (i + 1) < slabs ? TREEVIEW_SLAB : pool->used;
+
+			for (size_t j = 0; j < used; j++) {
+				node_unpooled_destroy(&pool->slabs[i][j]);
+			}
+		}
+
+		for (size_t i = 0; i < slabs; i++) {
+			WIDGETS_FREE(pool->slabs[i]);
+		}
+
+		arrfree(pool->slabs);
+		arrfree(treeview->walk);
+		arrfree(treeview->filter.query);
+		arrfree(treeview->filter.matches);
+		arrfree(treeview->filter.ends);
+		memset(treeview, 0, sizeof(*treeview));
+	}
+}
+
+/* Returns the row of the selected node, starting from 1. */
+static int
+selected_row(struct treeview *treeview) {
+	/* -1 as the root node is not visible. */
+	int row = node_height_bottom_to_up(treeview->selected) - 1;
+
+	assert(row > 0);
+
+	return row;
+}
+
+/* Scrolls so that the selected node is visible in the given height and returns
+ * the offset of it's row from the first visible row. */
+static int
+treeview_scroll(struct treeview *treeview, int height) {
+	int row = selected_row(treeview);
+	int diff_forward = row - (treeview->start_y + height);
+	int diff_backward = treeview->start_y - (row - 1);
+
+	if (diff_backward > 0) {
+		treeview->start_y -= diff_backward;
+	} else if (diff_forward > 0) {
+		treeview->start_y += diff_forward;
+	}
+
+	assert(treeview->start_y >= 0);
+	assert(treeview->start_y < row);
+
+	return row - 1 - treeview->start_y;
+}
+
+void
+treeview_redraw(struct treeview *treeview, struct widget_points *points) {
+	if (!treeview || !points
+		|| !(widget_points_in_bounds(points, points->x1, points->y1))) {
+		return;
+	}
+
+	/* Saved even when empty so that the first insert is damaged. */
+	treeview->points = *points;
+
+	if (!treeview->selected) {
+		return;
+	}
+
+	treeview_scroll(treeview, points->y2 - points->y1);
+
+	/* Only the nodes on the visible rows are visited. */
+	if (!walk_seek(treeview, (size_t) treeview->start_y)) {
+		return;
+	}
+
+	for (int y = points->y1; y < points->y2; y++) {
+		walk_draw(treeview, points, y);
+
+		if (!walk_next(treeview)) {
+			break;
+		}
+	}
+}
+
+static enum widget_error
+treeview_event_va(
+  struct treeview *treeview, enum treeview_event event, va_list vl) {
+	if (!treeview) {
+		return WIDGET_NOOP;
+	}
+
+	switch (event) {
+	case TREEVIEW_EXPAND:
+		if (!treeview->selected) {
+			break;
+		}
+
+		{
+			struct treeview_node *node = treeview->selected;
+			size_t rows = node_rows(node);
+
+			if (!node->is_expanded && node->populate_cb
+				&& !node->is_populated) {
+				node->is_populated = true;
+				node->populate_cb(treeview, node);
+				filter_levels_drop(treeview);
+			}
+
+			node->is_expanded = !node->is_expanded;
+			offsets_invalidate(node->parent, node->index + 1);
+			parents_rows_update(node->parent, node_rows(node), rows);
+
+			return WIDGET_REDRAW;
+		}
+	case TREEVIEW_UP:
+		if (!treeview->selected) {
+			break;
+		}
+
+		{
+			struct treeview_node *prev = sibling_prev(treeview->selected);
+
+			if (prev) {
+				treeview->selected = leaf(prev); /* Bottom node. */
+			} else if (treeview->selected->parent->parent) {
+				treeview->selected = treeview->selected->parent;
+			} else {
+				treeview->start_y = 0; /* Scroll up to the title if we're
+										  already at the top-most node. */
+			}
+
+			return WIDGET_REDRAW;
+		}
+	case TREEVIEW_DOWN:
+		if (!treeview->selected) {
+			break;
+		}
+
+		{
+			struct treeview_node *next = treeview->selected->is_expanded
+										   ? child_first(treeview->selected)
+										   : NULL; /* First node. */
+
+			if (!next) {
+				/* NULL at the end-most node of the tree. */
+				next = node_next(treeview->selected);
+			}
+
+			if (next) {
+				treeview->selected = next;
+			}
+
+			return WIDGET_REDRAW;
+		}
+	case TREEVIEW_INSERT:
+		{
+			if (!treeview->selected) {
+				break;
+			}
+
+			/* https://bugs.llvm.org/show_bug.cgi?id=41311
+			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
+			struct treeview_node *nnode = va_arg(vl, struct treeview_node *);
+
+			if (treeview_node_add_child(treeview->selected, nnode) == -1) {
+				break;
+			}
+
+			filter_levels_drop(treeview);
+
+			return WIDGET_REDRAW;
+		}
+	case TREEVIEW_INSERT_PARENT:
+		{
+			/* https://bugs.llvm.org/show_bug.cgi?id=41311
+			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
+			struct treeview_node *nnode = va_arg(vl, struct treeview_node *);
+
+			if (!nnode) {
+				break;
+			}
+
+			treeview_node_add_child(!treeview->selected
+									  ? &treeview->root
+									  : treeview->selected->parent,
+			  nnode);
+			filter_levels_drop(treeview);
+
+			/* The selection is only set for the first entry. */
+			if (!treeview->selected) {
+				treeview->selected = nnode;
+			}
+
+			return WIDGET_REDRAW;
+		}
+	case TREEVIEW_JUMP:
+		{
+			/* https://bugs.llvm.org/show_bug.cgi?id=41311
+			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
+			struct treeview_node *nnode = va_arg(vl, struct treeview_node *);
+
+			if (!nnode) {
+				break;
+			}
+
+			/* Nodes know their position, so nothing has to be searched. */
+			assert(nnode->parent);
+			assert(nnode->parent->nodes[nnode->index] == nnode);
+
+			if (!(node_is_shown(nnode))) {
+				break;
+			}
+
+			treeview->selected = nnode;
+
+			return WIDGET_REDRAW;
+		}
+	case TREEVIEW_DELETE:
+		{
+			struct treeview_node *current = treeview->selected;
+
+			if (!current) {
+				break;
+			}
+
+			struct treeview_node *parent = current->parent;
+			size_t index = current->index;
+			/* Found before the rows change as the offsets are used. */
+			struct treeview_node *next = sibling_next(current);
+			struct treeview_node *prev = next ? NULL : sibling_prev(current);
+
+			arrdel(parent->nodes, index);
+			offsets_invalidate(parent, index);
+			parents_rows_update(parent, 0, node_rows(current));
+			filter_levels_drop(treeview);
+
+			children_reindex(parent, index);
+
+			if (next) {
+				treeview->selected = next;
+			} else if (prev) {
+				treeview->selected = prev;
+			} else if (parent->parent) {
+				/* Move up a level. */
+				treeview->selected = current->parent;
+			} else {
+				/* At top level and all nodes deleted. */
+				treeview->selected = NULL;
+			}
+
+			treeview_node_destroy(current);
+
+			return WIDGET_REDRAW;
+		}
+	case TREEVIEW_MOVE:
+		{
+			/* https://bugs.llvm.org/show_bug.cgi?id=41311
+			 * NOLINTNEXTLINE(clang-analyzer-valist.Uninitialized) */
+			struct treeview_node *nnode = va_arg(vl, struct treeview_node *);
+
+			if (!treeview->selected
+				|| treeview_node_reparent(treeview, treeview->selected, nnode)
+					 == -1) {
+				break;
+			}
+
+			return WIDGET_REDRAW;
+		}
+	default:
+		assert(0);
+		break;
+	}
+
+	return WIDGET_NOOP;
+}
+
+enum widget_error
+treeview_event(struct treeview *treeview, enum treeview_event event, ...) {
+	va_list vl = {0};
+	va_start(vl, event);
+	enum widget_error ret = treeview_event_va(treeview, event, vl);
+	va_end(vl);
+
+	return ret;
+}
+
+enum widget_error
+treeview_event_damage(struct treeview *treeview, struct widget_points *damage,
+  enum treeview_event event, ...) {
+	struct widget_points points = treeview ? treeview->points
+										   : (struct widget_points) {0};
+	bool drawn = (widget_points_in_bounds(&points, points.x1, points.y1));
+	int start_y = treeview ? treeview->start_y : 0;
+	int old_y = -1;
+
+	if (drawn && treeview->selected) {
+		old_y = points.y1 + (selected_row(treeview) - 1) - start_y;
+	}
+
+	struct treeview_node *nnode = NULL;
+	va_list vl = {0};
+	va_start(vl, event);
+
+	if (event == TREEVIEW_INSERT_PARENT) {
+		va_list copy;
+		va_copy(copy, vl);
+		nnode = va_arg(copy, struct treeview_node *);
+		va_end(copy);
+	}
+
+	enum widget_error ret = treeview_event_va(treeview, event, vl);
+	va_end(vl);
+
+	if (!damage) {
+		return ret;
+	}
+
+	*damage = (struct widget_points) {0};
+
+	if (ret != WIDGET_REDRAW || !drawn) {
+		return ret;
+	}
+
+	int height = points.y2 - points.y1;
+	int new_y = treeview->selected
+				? points.y1 + treeview_scroll(treeview, height)
+				: -1;
+
+	if (treeview->start_y != start_y || old_y < points.y1 || old_y >= points.y2
+		|| new_y < 0) {
+		*damage = points;
+		return ret;
+	}
+
+	switch (event) {
+	case TREEVIEW_UP:
+	case TREEVIEW_DOWN:
+	case TREEVIEW_JUMP:
+		/* Only the selection moved. */
+		*damage = damage_rows(&points, old_y, new_y);
+		break;
+	case TREEVIEW_INSERT_PARENT:
+		{
+			int y = min(old_y, new_y);
+
+			/* Sorted nodes can go before the selected one, shifting the rows
+			 * from there down. */
+			if (node_is_shown(nnode)) {
+				y = min(y, points.y1 + node_height_bottom_to_up(nnode) - 2
+							 - start_y);
+			}
+
+			*damage = damage_rows(&points, y, points.y2 - 1);
+			break;
+		}
+	case TREEVIEW_MOVE:
+		/* The branches of the old and new siblings above change too. */
+		*damage = points;
+		break;
+	default:
+		/* Nodes after the selected one might have moved. */
+		*damage = damage_rows(&points, min(old_y, new_y), points.y2 - 1);
+		break;
+	}
+
+	return ret;
+}
+
+#ifdef WIDGETS_TESTS
+#include <assert.h>
+#include <locale.h>
+
+static void
+draw_noop(void *data, struct widget_points *points, bool is_selected) {
+	(void) data;
+	(void) points;
+	(void) is_selected;
+}
+
+static void
+draw_str(void *data, struct widget_points *points, bool is_selected) {
+	(void) is_selected;
+	widget_print_str(
+	  points->x1, points->y1, points->x2, TB_DEFAULT, TB_DEFAULT, data);
+}
+
+/* Adds 3 children and counts the calls in the node's data. */
+static void
+populate_three(struct treeview *treeview, struct treeview_node *node) {
+	(*(int *) node->data)++;
+
+	for (int i = 0; i < 3; i++) {
+		treeview_node_add_child(
+		  node, treeview_pool_alloc(treeview, NULL, draw_noop));
+	}
+}
+
+static int
+compare_data(const struct treeview_node *a, const struct treeview_node *b) {
+	return strcmp(a->data, b->data);
+}
+
+int
+main(void) {
+	assert(widget_headless_init(80, 24) == 0);
+	setlocale(LC_ALL, "");
+
+	{
+		struct widget_points points = {0};
+
+		widget_points_set(&points, 0, 1, 0, 1);
+		assert(widget_points_in_bounds(&points, points.x1, points.y1));
+		widget_points_set(&points, 0, 2, 5, 5);
+		assert(!widget_points_in_bounds(&points, points.x1, points.y1));
+		widget_points_set(&points, 5, 5, 5, 5);
+		assert(!widget_points_in_bounds(&points, points.x1, points.y1));
+		widget_points_set(&points, -1, widget_width() + 1, -1, widget_height() + 1);
+		assert(points.x1 == 0);
+		assert(points.x2 == widget_width());
+		assert(points.y1 == 0);
+		assert(points.y2 == widget_height());
+
+		assert(widget_str_width("Test") == 4);
+		assert(widget_str_width("😄") == 2);
+		assert(widget_str_width("Test 😄") == 7);
+		assert(widget_str_width("├──") == 3);
+		assert(widget_str_width("│") == 1);
+		assert(widget_str_width("└──") == 3);
+		assert(widget_str_width("\n") == 0);
+
+		{
+			/* Long enough to take the vectorized path at every alignment. */
+			char long_str[] = "The quick brown fox jumps over the lazy dog, "
+							  "the quick brown fox jumps over the lazy dog.";
+			int long_len = (int) strlen(long_str);
+
+			for (int i = 0; i < long_len; i++) {
+				assert(widget_str_width(&long_str[i]) == long_len - i);
+			}
+
+			long_str[long_len - 3] = '\n';
+			assert(widget_str_width(long_str) == long_len - 1);
+			assert(widget_print_str(0, 0, 100, TB_DEFAULT, TB_DEFAULT, long_str)
+				   == long_len - 3);
+			assert(widget_print_str(0, 0, 10, TB_DEFAULT, TB_DEFAULT, long_str)
+				   == 10);
+			assert(widget_print_str(5, 0, 2, TB_DEFAULT, TB_DEFAULT, long_str)
+				   == 0);
+
+			assert(widget_str_width("The quick brown fox jumps over the "
+									"lazy dog 😄 over and over again")
+				   == 66);
+		}
+#define print_str(str, max_x)                                                  \
+	widget_print_str(0, 0, max_x, TB_DEFAULT, TB_DEFAULT, str)
+		const int large_testx = 100;
+
+		assert(print_str("Test", large_testx) == 4);
+		assert(print_str("Test", 4) == 4);
+		assert(print_str("Test", 3) == 3);
+		assert(print_str("Test", 0) == 0);
+		assert(print_str("Te\nst", large_testx) == 2);
+		assert(print_str("😄", large_testx) == 2);
+		assert(print_str("😄", 2) == 2);
+		assert(print_str("😄", 1) == 0);
+		assert(print_str("├──", large_testx) == 3);
+		assert(print_str("├──", 3) == 3);
+		assert(print_str("├──", 2) == 2);
+		assert(print_str("│", 1) == 1);
+		assert(print_str("│", 0) == 0);
+		assert(print_str("Test 😄", large_testx) == 7);
+		assert(print_str("Test 😄", 6) == 5);
+#undef print_str
+
+		{
+			int width = 0;
+
+			assert(widget_uc_sanitize('\n', &width) == '\n');
+			assert(width == 0);
+			assert(widget_should_forcebreak(width));
+			assert(widget_should_scroll(0, 0, 0));
+
+			assert(widget_uc_sanitize('\t', &width) == ' ');
+			assert(width == 1);
+
+			assert(widget_uc_sanitize(L'😄', &width) == L'😄');
+			assert(width == 2);
+
+			/* Combining and zero width codepoints are replaced. */
+			assert(widget_uc_sanitize(0x301, &width) == L'�');
+			assert(width == 1);
+			assert(widget_uc_sanitize(0x200B, &width) == L'�');
+			assert(width == 1);
+
+			/* Non-printable codepoints are passed through. */
+			assert(widget_uc_sanitize(0x1B, &width) == 0x1B);
+			assert(width == 1);
+
+			assert(widget_uc_sanitize(L'é', &width) == L'é');
+			assert(width == 1);
+			assert(widget_uc_sanitize(L'漢', &width) == L'漢');
+			assert(width == 2);
+			assert(widget_uc_sanitize(0x20000, &width) == 0x20000);
+			assert(width == 2);
+			assert(widget_uc_sanitize(0x10FFFF, &width) == 0x10FFFF);
+			assert(width == 1);
+		}
+
+		assert(!widget_should_scroll(widget_width() - 1, 1, widget_width()));
+		assert(widget_should_scroll(widget_width(), 1, widget_width()));
+
+		{
+			const char *strs[] = {"", "Test", "Test 😄", "Te\nst", "\t├──",
+			  "😄😄😄"};
+			const int max_xs[] = {0, 1, 2, 3, 4, 6, 7, 100};
+			const size_t max_xs_len = sizeof(max_xs) / sizeof(*max_xs);
+
+			for (size_t i = 0; i < (sizeof(strs) / sizeof(*strs)); i++) {
+				struct widget_text text = {0};
+
+				assert(widget_text_init(&text, strs[i]) == 0);
+				assert(widget_text_width(&text) == widget_str_width(strs[i]));
+
+				for (size_t j = 0; j < max_xs_len; j++) {
+					assert(widget_text_print(
+							 &text, 0, 0, max_xs[j], TB_DEFAULT, TB_DEFAULT)
+						   == widget_print_str(0, 0, max_xs[j], TB_DEFAULT,
+							 TB_DEFAULT, strs[i]));
+				}
+
+				widget_text_finish(&text);
+			}
+
+			struct widget_text text = {0};
+
+			assert(widget_text_init(&text, "a😄b") == 0);
+			assert(text.len == 3);
+			assert(widget_text_fit(&text, 0) == 0);
+			assert(widget_text_fit(&text, 1) == 1);
+			assert(widget_text_fit(&text, 2) == 1);
+			assert(widget_text_fit(&text, 3) == 2);
+			assert(widget_text_fit(&text, 4) == 3);
+			assert(widget_text_fit(&text, 100) == 3);
+			widget_text_finish(&text);
+		}
+
+		assert(widget_pad_center(40, 80) == 20);
+		assert(widget_pad_center(26, 85) == 30);
+		assert(widget_pad_center(50, 10) == 0);
+	}
+
+	{
+		struct widget_shadow shadow;
+		struct widget_points damage = {0};
+		const int max_x = widget_width();
+
+		assert(widget_shadow_init(&shadow) == 0);
+
+		widget_shadow_begin(&shadow);
+		assert(widget_print_str(1, 1, max_x, TB_DEFAULT, TB_DEFAULT, "Test")
+			   == 4);
+		widget_shadow_end(&shadow, &damage);
+		assert(damage.x1 == 1 && damage.x2 == 5);
+		assert(damage.y1 == 1 && damage.y2 == 2);
+
+		/* Nothing changed. */
+		widget_shadow_begin(&shadow);
+		widget_print_str(1, 1, max_x, TB_DEFAULT, TB_DEFAULT, "Test");
+		widget_shadow_end(&shadow, &damage);
+		assert(damage.x1 == damage.x2);
+
+		/* Only the changed and cleared cells are damaged. */
+		widget_shadow_begin(&shadow);
+		widget_print_str(1, 1, max_x, TB_DEFAULT, TB_DEFAULT, "Tex");
+		widget_shadow_end(&shadow, &damage);
+		assert(damage.x1 == 3 && damage.x2 == 5);
+		assert(damage.y1 == 1 && damage.y2 == 2);
+
+		widget_shadow_begin(&shadow);
+		widget_shadow_end(&shadow, &damage);
+		assert(damage.x1 == 1 && damage.x2 == 4);
+
+		/* Cells left from before a reset are cleared with it. */
+		widget_shadow_begin(&shadow);
+		widget_print_str(1, 1, max_x, TB_DEFAULT, TB_DEFAULT, "Test");
+		widget_shadow_end(&shadow, &damage);
+		shadow.frame = UINT_MAX;
+		widget_shadow_begin(&shadow);
+		widget_shadow_end(&shadow, &damage);
+		assert(widget_headless_cell(1, 1)->ch == ' ');
+
+		widget_shadow_finish(&shadow);
+	}
+
+	{
+		struct widget_points border = {0};
+		struct widget_points snapshot = {0};
+		struct input input;
+		int rows = 0;
+		int x = 0;
+		int y = 0;
+
+		widget_headless_clear();
+		widget_points_set(&border, 2, 6, 1, 4);
+		widget_points_set(&snapshot, 0, 8, 0, 5);
+		border_redraw(&border, TB_DEFAULT, TB_DEFAULT);
+		assert(widget_headless_compare(&snapshot, "\n"
+												  "  ┌──┐\n"
+												  "  │  │\n"
+												  "  └──┘\n"
+												  "\n")
+			   == -1);
+		assert(widget_headless_compare(&snapshot, "\n  ┌─┐\n") == 1);
+
+		widget_headless_clear();
+		widget_points_set(&snapshot, 0, 10, 20, 24);
+		assert(input_init(&input, TB_DEFAULT, false) == 0);
+
+		for (const char *str = "Hello 😄 World"; *str;) {
+			uint32_t uc = 0;
+			str += tb_utf8_char_to_unicode(&uc, str);
+			input_handle_event(&input, INPUT_ADD, uc);
+		}
+
+		input_redraw(&input, &snapshot, &rows, false);
+		assert(rows == 2);
+		assert(widget_headless_compare(&snapshot, "\n"
+												  "\n"
+												  "Hello 😄\n"
+												  "World\n")
+			   == -1);
+		widget_headless_cursor(&x, &y);
+		assert(x == 5 && y == 23);
+
+		assert(input_handle_event(&input, INPUT_DOWN) == WIDGET_NOOP);
+		assert(input_handle_event(&input, INPUT_UP) == WIDGET_REDRAW);
+		assert(input.cur_buf == 5);
+		assert(input_handle_event(&input, INPUT_UP) == WIDGET_NOOP);
+		assert(input_handle_event(&input, INPUT_END) == WIDGET_REDRAW);
+		assert(input.cur_buf == 7);
+		assert(input_handle_event(&input, INPUT_PAGE_DOWN) == WIDGET_REDRAW);
+		assert(input.cur_buf == 13);
+		assert(input_handle_event(&input, INPUT_HOME) == WIDGET_REDRAW);
+		assert(input.cur_buf == 8);
+		assert(input_handle_event(&input, INPUT_END) == WIDGET_REDRAW);
+		assert(input.cur_buf == 13);
+
+		/* Scrolled to the cursor's line. */
+		widget_headless_clear();
+		widget_points_set(&snapshot, 0, 10, 20, 21);
+		input_redraw(&input, &snapshot, &rows, false);
+		assert(rows == 1 && input.start_y == 1);
+		assert(widget_headless_compare(&snapshot, "World\n") == -1);
+
+		widget_headless_clear();
+		input_handle_event(&input, INPUT_LEFT_WORD);
+		input_handle_event(&input, INPUT_LEFT_WORD);
+		input_redraw(&input, &snapshot, &rows, false);
+		assert(input.start_y == 0);
+		assert(widget_headless_compare(&snapshot, "Hello 😄\n") == -1);
+		widget_headless_cursor(&x, &y);
+		assert(x == 6 && y == 20);
+
+		/* The horizontal view follows the cursor. */
+		widget_headless_clear();
+		widget_points_set(&snapshot, 0, 5, 20, 21);
+		input.scroll_horizontal = true;
+		input_handle_event(&input, INPUT_RIGHT_WORD);
+		input_redraw(&input, &snapshot, &rows, false);
+		assert(widget_headless_compare(&snapshot, " 😄\n") == -1);
+		widget_headless_cursor(&x, &y);
+		assert(x == 3 && y == 20);
+
+		widget_headless_clear();
+		input_handle_event(&input, INPUT_LEFT);
+		input_handle_event(&input, INPUT_LEFT);
+		input_redraw(&input, &snapshot, &rows, false);
+		assert(widget_headless_compare(&snapshot, "llo\n") == -1);
+		widget_headless_cursor(&x, &y);
+		assert(x == 3 && y == 20);
+
+		input_finish(&input);
+		widget_headless_clear();
+	}
+
+	struct widget_points points = {0};
+	widget_points_set(&points, 0, 80, 0, 24);
+
+	{
+		int x = 78;
+		int y = 0;
+
+		assert(!widget_advance_xy_if_scroll(&x, &y, &points, 2));
+		assert(y == 0);
+		assert(x == 78);
+
+		x = 80;
+
+		points.x1 = 2;
+
+		assert(widget_advance_xy_if_scroll(&x, &y, &points, 1));
+		assert(y == 1);
+		assert(x == 2);
+
+		points.x1 = 0;
+	}
+
+	{
+		struct input input;
+		int rows = 0;
+
+		assert(input_init(&input, TB_DEFAULT, false) == 0);
+		input_redraw(&input, &points, &rows, false);
+		assert(rows == 1);
+
+		input.scroll_horizontal = true;
+		input_redraw(&input, &points, &rows, false);
+		assert(rows == 1);
+
+		input.scroll_horizontal = false;
+
+		for (size_t i = 0; i < BUF_MAX; i++) {
+			assert(input_handle_event(&input, INPUT_ADD, ' ') == WIDGET_REDRAW);
+		}
+
+		assert(input_handle_event(&input, INPUT_ADD, ' ') == WIDGET_NOOP);
+		input_redraw(&input, &points, &rows, false);
+		assert(rows == 24);
+
+		input.scroll_horizontal = true;
+		input_redraw(&input, &points, &rows, false);
+		assert(rows == 1);
+		input.scroll_horizontal = false;
+
+		char *buf = input_buf(&input);
+		assert(strlen(buf) == 2000);
+		free(buf);
+		buf = NULL;
+
+		input_handle_event(&input, INPUT_CLEAR);
+		assert(input_buf(&input) == NULL);
+
+		input_finish(&input);
+		assert(input_init(&input, TB_DEFAULT, false) == 0);
+
+		char *buf_test = "Test";
+
+		/* Empty. */
+		for (enum input_event event = INPUT_DELETE; event < INPUT_ADD;
+			 event++) {
+			assert(input_handle_event(&input, event) == WIDGET_NOOP);
+		}
+
+		for (size_t i = 0, len = strlen(buf_test); i < len; i++) {
+			assert(input_handle_event(&input, INPUT_ADD, buf_test[i])
+				   == WIDGET_REDRAW);
+		}
+
+		assert(input.cur_buf == 4);
+
+		assert(input_len(&input) == strlen(buf_test));
+		char *buf_input = input_buf(&input);
+		assert(strcmp(buf_test, buf_input) == 0);
+		free(buf_input);
+
+		assert(input_handle_event(&input, INPUT_LEFT) == WIDGET_REDRAW);
+		assert(input.cur_buf == 3);
+		assert(input_handle_event(&input, INPUT_LEFT_WORD) == WIDGET_REDRAW);
+		assert(input.cur_buf == 0);
+
+		assert(input_handle_event(&input, INPUT_RIGHT) == WIDGET_REDRAW);
+		assert(input.cur_buf == 1);
+		assert(input_handle_event(&input, INPUT_RIGHT_WORD) == WIDGET_REDRAW);
+		assert(input.cur_buf == 4);
+
+		assert(input_handle_event(&input, INPUT_LEFT) == WIDGET_REDRAW);
+		assert(input.cur_buf == 3);
+
+		assert(input_handle_event(&input, INPUT_ADD, 'i') == WIDGET_REDRAW);
+		assert(input.cur_buf == 4);
+
+		assert(input_handle_event(&input, INPUT_LEFT) == WIDGET_REDRAW);
+		assert(input.cur_buf == 3);
+
+		assert(input_handle_event(&input, INPUT_RIGHT_WORD) == WIDGET_REDRAW);
+		assert(input.cur_buf == 5);
+
+		assert(input_handle_event(&input, INPUT_DELETE) == WIDGET_REDRAW);
+		buf_input = input_buf(&input);
+		assert(strcmp("Tesi", buf_input) == 0);
+		free(buf_input);
+
+		assert(input_handle_event(&input, INPUT_DELETE_WORD) == WIDGET_REDRAW);
+		assert(input_buf(&input) == NULL);
+
+		/* Edits away from the end with the limit lifted. */
+		input.max_len = 0;
+
+		for (size_t i = 0; i < (BUF_MAX * 4); i++) {
+			assert(input_handle_event(&input, INPUT_ADD, 'a' + (i % 26))
+				   == WIDGET_REDRAW);
+		}
+
+		assert(input_len(&input) == (BUF_MAX * 4));
+		input.cur_buf = 1;
+		assert(input_handle_event(&input, INPUT_ADD, ' ') == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_ADD, 'x') == WIDGET_REDRAW);
+		input.cur_buf = 27;
+		assert(input_handle_event(&input, INPUT_DELETE) == WIDGET_REDRAW);
+		input.cur_buf = 2;
+		assert(input_handle_event(&input, INPUT_RIGHT_WORD) == WIDGET_REDRAW);
+		assert(input.cur_buf == (BUF_MAX * 4) + 1);
+		assert(input_handle_event(&input, INPUT_DELETE_WORD) == WIDGET_REDRAW);
+		assert(input.cur_buf == 2);
+		input.cur_buf = 0;
+		assert(input_handle_event(&input, INPUT_ADD, 'b') == WIDGET_REDRAW);
+
+		buf_input = input_buf(&input);
+		assert(strcmp("ba ", buf_input) == 0);
+		free(buf_input);
+
+		const char *paste = "xy\n😄z";
+		const uint32_t paste_utf32[] = {'1', '2', '3'};
+
+		input.cur_buf = 1;
+		assert(input_handle_event(&input, INPUT_ADD_STR, paste, strlen(paste))
+			   == WIDGET_REDRAW);
+		assert(input.cur_buf == 6);
+		/* Stops at the truncated emoji. */
+		assert(input_handle_event(&input, INPUT_ADD_STR, paste, (size_t) 5)
+			   == WIDGET_REDRAW);
+		assert(input.cur_buf == 9);
+		assert(input_handle_event(&input, INPUT_ADD_STR, "", (size_t) 0)
+			   == WIDGET_NOOP);
+
+		input.max_len = 12;
+		assert(input_handle_event(
+				 &input, INPUT_ADD_UTF32, paste_utf32, (size_t) 3)
+			   == WIDGET_REDRAW);
+		assert(input_len(&input) == 12 && input.cur_buf == 10);
+		assert(input_handle_event(
+				 &input, INPUT_ADD_UTF32, paste_utf32, (size_t) 3)
+			   == WIDGET_NOOP);
+
+		buf_input = input_buf(&input);
+		assert(strcmp("bxy\n😄zxy\n1a ", buf_input) == 0);
+		free(buf_input);
+
+		char small[8];
+
+		assert(input_buf_into(&input, NULL, 0) == 15);
+		/* The emoji doesn't fit whole. */
+		assert(input_buf_into(&input, small, sizeof(small)) == 15);
+		assert(strcmp("bxy\n", small) == 0);
+		assert(input_handle_event(&input, INPUT_DELETE_WORD) == WIDGET_REDRAW);
+		assert(input_buf_into(&input, NULL, 0) == 14);
+
+		input_finish(&input);
+	}
+
+	{
+		struct input input;
+		char text[16];
+
+		assert(input_init(&input, TB_DEFAULT, false) == 0);
+
+		for (const char *str = "foo bar"; *str; str++) {
+			input_handle_event(&input, INPUT_ADD, *str);
+		}
+
+		/* Typing is undone a word at a time. */
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("foo ", text) == 0 && input.cur_buf == 4);
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		assert(input_len(&input) == 0);
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_NOOP);
+		assert(input_handle_event(&input, INPUT_REDO) == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_REDO) == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_REDO) == WIDGET_NOOP);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("foo bar", text) == 0 && input.cur_buf == 7);
+
+		/* So is erasing. */
+		input_handle_event(&input, INPUT_DELETE);
+		input_handle_event(&input, INPUT_DELETE);
+		input_handle_event(&input, INPUT_DELETE);
+		input_handle_event(&input, INPUT_DELETE);
+		input_handle_event(&input, INPUT_DELETE);
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("foo", text) == 0);
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("foo bar", text) == 0 && input.cur_buf == 7);
+
+		assert(input_handle_event(&input, INPUT_CLEAR) == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		assert(input_len(&input) == 7);
+
+		/* New edits drop what could be redone. */
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		input_handle_event(&input, INPUT_ADD, '!');
+		assert(input_handle_event(&input, INPUT_REDO) == WIDGET_NOOP);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("foo !", text) == 0);
+
+		/* Only the newest edits are kept. */
+		input.journal.max = 4;
+
+		for (const char *str = "abcdefgh"; *str; str++) {
+			input_handle_event(&input, INPUT_ADD, *str);
+			input_handle_event(&input, INPUT_LEFT);
+			input_handle_event(&input, INPUT_RIGHT);
+		}
+
+		while (input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW) {}
+
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("foo !abcd", text) == 0);
+
+		input_finish(&input);
+	}
+
+	{
+		struct input input;
+		char text[16];
+		const char *sent[] = {"ls", "cd /", "ls -l", "ls -l"};
+
+		assert(input_init(&input, TB_DEFAULT, false) == 0);
+
+		for (size_t i = 0; i < (sizeof(sent) / sizeof(*sent)); i++) {
+			input_handle_event(
+			  &input, INPUT_ADD_STR, sent[i], strlen(sent[i]));
+			input_handle_event(&input, INPUT_HISTORY_PUSH);
+			input_handle_event(&input, INPUT_CLEAR);
+		}
+
+		/* The repeated entry was only added once. */
+		assert(input_handle_event(&input, INPUT_HISTORY_PREV) == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_HISTORY_PREV) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("cd /", text) == 0 && input.cur_buf == 4);
+		assert(input_handle_event(&input, INPUT_HISTORY_NEXT) == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_HISTORY_NEXT) == WIDGET_REDRAW);
+		assert(input_len(&input) == 0);
+		assert(input_handle_event(&input, INPUT_HISTORY_NEXT) == WIDGET_NOOP);
+
+		/* Searching keeps the cursor after the prefix. */
+		input_handle_event(&input, INPUT_ADD, 'l');
+		assert(
+		  input_handle_event(&input, INPUT_HISTORY_SEARCH) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("ls -l", text) == 0 && input.cur_buf == 1);
+		assert(
+		  input_handle_event(&input, INPUT_HISTORY_SEARCH) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("ls", text) == 0);
+		assert(input_handle_event(&input, INPUT_HISTORY_SEARCH) == WIDGET_NOOP);
+
+		/* Recalls are undone at once. */
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("l", text) == 0);
+
+		/* Without a prefix every older entry matches. */
+		input.cur_buf = 0;
+		assert(
+		  input_handle_event(&input, INPUT_HISTORY_SEARCH) == WIDGET_REDRAW);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("ls -l", text) == 0 && input.cur_buf == 0);
+		assert(input_handle_event(&input, INPUT_UNDO) == WIDGET_REDRAW);
+
+		/* The oldest entries are dropped to make room. */
+		input.history.max = 6;
+		input_handle_event(&input, INPUT_HISTORY_PUSH);
+		input_handle_event(&input, INPUT_ADD_STR, "abcd", (size_t) 4);
+		input_handle_event(&input, INPUT_HISTORY_PUSH);
+		input_handle_event(&input, INPUT_CLEAR);
+		input_handle_event(&input, INPUT_ADD_STR, "xyz", (size_t) 3);
+		input_handle_event(&input, INPUT_HISTORY_PUSH);
+		input_handle_event(&input, INPUT_CLEAR);
+		assert(input_handle_event(&input, INPUT_HISTORY_PREV) == WIDGET_REDRAW);
+		assert(input_handle_event(&input, INPUT_HISTORY_PREV) == WIDGET_NOOP);
+		input_buf_into(&input, text, sizeof(text));
+		assert(strcmp("xyz", text) == 0);
+
+		input_finish(&input);
+	}
+
+	{
+		struct input input;
+		struct widget_points damage = {0};
+		int rows = 0;
+
+		assert(input_init(&input, TB_DEFAULT, false) == 0);
+		assert(input_handle_event_damage(&input, &damage, INPUT_ADD, 'a')
+			   == WIDGET_REDRAW);
+		assert(damage.x1 == damage.x2); /* Not drawn yet. */
+
+		input_handle_event(&input, INPUT_ADD, 'b');
+		input_handle_event(&input, INPUT_ADD, 'c');
+		input_redraw(&input, &points, &rows, false);
+		assert(rows == 1);
+
+		/* Only the cursor moves. */
+		assert(input_handle_event_damage(&input, &damage, INPUT_LEFT)
+			   == WIDGET_REDRAW);
+		assert(damage.x1 == 2 && damage.x2 == 4);
+		assert(damage.y1 == points.y2 - 1 && damage.y2 == points.y2);
+
+		/* The rest of the row is damaged. */
+		assert(input_handle_event_damage(&input, &damage, INPUT_ADD, 'x')
+			   == WIDGET_REDRAW);
+		assert(damage.x1 == points.x1 && damage.x2 == points.x2);
+		assert(damage.y1 == points.y2 - 1 && damage.y2 == points.y2);
+
+		/* Adding a row moves everything. */
+		assert(input_handle_event_damage(&input, &damage, INPUT_ADD, '\n')
+			   == WIDGET_REDRAW);
+		assert(damage.x1 == points.x1 && damage.x2 == points.x2);
+		assert(damage.y1 == points.y1 && damage.y2 == points.y2);
+
+		input_finish(&input);
+	}
+
+	{
+		struct treeview treeview;
+		struct widget_points damage = {0};
+
+		assert(treeview_init(&treeview) == 0);
+
+		/* Drawn while empty, so the first node damages everything. */
+		treeview_redraw(&treeview, &points);
+		assert(treeview_event_damage(&treeview, &damage, TREEVIEW_INSERT_PARENT,
+				 treeview_node_alloc(NULL, draw_noop))
+			   == WIDGET_REDRAW);
+		assert(damage.x1 == points.x1 && damage.x2 == points.x2);
+		assert(damage.y1 == points.y1 && damage.y2 == points.y2);
+
+		for (int i = 0; i < 2; i++) {
+			struct treeview_node *node = treeview_node_alloc(NULL, draw_noop);
+
+			assert(node);
+			assert(treeview_event(&treeview, TREEVIEW_INSERT_PARENT, node)
+				   == WIDGET_REDRAW);
+		}
+
+		treeview_redraw(&treeview, &points);
+
+		/* Two rows change when moving the selection. */
+		assert(treeview_event_damage(&treeview, &damage, TREEVIEW_DOWN)
+			   == WIDGET_REDRAW);
+		assert(damage.x1 == points.x1 && damage.x2 == points.x2);
+		assert(damage.y1 == points.y1 && damage.y2 == points.y1 + 2);
+
+		/* Everything after the selected node when deleting. */
+		assert(treeview_event_damage(&treeview, &damage, TREEVIEW_DELETE)
+			   == WIDGET_REDRAW);
+		assert(damage.y1 == points.y1 + 1 && damage.y2 == points.y2);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		struct treeview_node *nodes[3];
+		struct widget_points row = {0};
+
+		assert(treeview_init(&treeview) == 0);
+
+		for (size_t i = 0; i < (sizeof(nodes) / sizeof(*nodes)); i++) {
+			nodes[i] = treeview_node_alloc(NULL, draw_noop);
+			assert(nodes[i]);
+		}
+
+		/* Rows are counted for subtrees built before being inserted. */
+		assert(treeview_node_add_child(nodes[1], nodes[2]) == 0);
+		assert(treeview_event(&treeview, TREEVIEW_INSERT_PARENT, nodes[0])
+			   == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_INSERT, nodes[1])
+			   == WIDGET_REDRAW);
+		assert(nodes[0]->visible == 2 && treeview.root.visible == 3);
+
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(nodes[0]->visible == 2 && treeview.root.visible == 1);
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(treeview.root.visible == 3);
+
+		/* Scrolled so that the last row is shown. */
+		widget_points_set(&row, 0, 10, 0, 1);
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		treeview_redraw(&treeview, &row);
+		assert(treeview.selected == nodes[2] && treeview.start_y == 2);
+
+		assert(treeview_event(&treeview, TREEVIEW_DELETE) == WIDGET_REDRAW);
+		assert(nodes[1]->visible == 0 && treeview.root.visible == 2);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		struct treeview_node *nodes[5];
+		const char *strs[] = {"a", "b", "c", "d", "e"};
+		struct widget_points snapshot = {0};
+
+		assert(treeview_init(&treeview) == 0);
+
+		for (size_t i = 0; i < (sizeof(nodes) / sizeof(*nodes)); i++) {
+			nodes[i] = treeview_node_alloc((void *) strs[i], draw_str);
+			assert(nodes[i]);
+		}
+
+		assert(treeview_node_add_child(nodes[1], nodes[2]) == 0);
+		assert(treeview_node_add_child(nodes[0], nodes[1]) == 0);
+		assert(treeview_node_add_child(nodes[0], nodes[3]) == 0);
+		assert(treeview_node_add_child(&treeview.root, nodes[0]) == 0);
+		assert(treeview_node_add_child(&treeview.root, nodes[4]) == 0);
+		assert(treeview_event(&treeview, TREEVIEW_JUMP, nodes[2])
+			   == WIDGET_REDRAW);
+
+		/* Drawing starts from a node in the middle of the tree. */
+		widget_headless_clear();
+		widget_points_set(&snapshot, 0, 10, 0, 2);
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "├──b\n"
+												  "│  └──c\n")
+			   == -1);
+
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		widget_headless_clear();
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "└──d\n"
+												  "e\n")
+			   == -1);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		struct treeview_node *node = NULL;
+		struct treeview_node *alone = treeview_node_alloc(NULL, draw_noop);
+
+		assert(treeview_init(&treeview) == 0);
+		assert(alone);
+
+		/* Spans several slabs, with a node allocated alone in the middle
+		 * which has pooled children and a long chain of them below. */
+		node = treeview_pool_alloc(&treeview, NULL, draw_noop);
+		assert(node && node->pool == &treeview.pool);
+		assert(treeview_event(&treeview, TREEVIEW_INSERT_PARENT, node)
+			   == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_INSERT, alone)
+			   == WIDGET_REDRAW);
+
+		for (size_t i = 0; i < TREEVIEW_SLAB * 2; i++) {
+			struct treeview_node *parent = i < TREEVIEW_SLAB ? alone : node;
+
+			node = treeview_pool_alloc(&treeview, NULL, draw_noop);
+			assert(node);
+			assert(treeview_node_add_child(parent, node) == 0);
+		}
+
+		assert(arrlenu(treeview.pool.slabs) == 3);
+		assert(treeview.root.visible == (TREEVIEW_SLAB * 2) + 2);
+		assert(alone->visible == TREEVIEW_SLAB * 2);
+
+		/* Deleted nodes are reused. */
+		assert(treeview_event(&treeview, TREEVIEW_JUMP, node)
+			   == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_DELETE) == WIDGET_REDRAW);
+		assert(treeview_pool_alloc(&treeview, NULL, draw_noop) == node);
+		treeview_node_destroy(node);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		int calls = 0;
+		struct treeview_node *node = NULL;
+
+		assert(treeview_init(&treeview) == 0);
+		node = treeview_pool_alloc(&treeview, &calls, draw_noop);
+		assert(node);
+		node->populate_cb = populate_three;
+		node->is_expanded = false;
+		assert(treeview_event(&treeview, TREEVIEW_INSERT_PARENT, node)
+			   == WIDGET_REDRAW);
+		assert(treeview.root.visible == 1 && !node->nodes);
+
+		/* Only populated on the first expansion. */
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(calls == 1 && treeview.root.visible == 4);
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(calls == 1 && treeview.root.visible == 4);
+
+		/* Children are only evicted while collapsed. */
+		assert(treeview_node_evict(&treeview, node) == -1);
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(treeview_node_evict(&treeview, node) == 0);
+		assert(!node->nodes && treeview.root.visible == 1);
+
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(calls == 2 && treeview.root.visible == 4);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		struct widget_points snapshot = {0};
+		const struct treeview_record records[] = {
+		  {0, "a", draw_str, NULL},
+		  {1, "b", draw_str, NULL},
+		  {2, "c", draw_str, NULL},
+		  {1, "d", draw_str, NULL},
+		  {0, "e", draw_str, NULL},
+		};
+		const struct treeview_record invalid[] = {
+		  {0, "a", draw_str, NULL},
+		  {2, "b", draw_str, NULL},
+		};
+
+		assert(treeview_init(&treeview) == 0);
+		assert(treeview_build(&treeview, NULL, invalid, 2) == -1);
+		assert(!treeview.root.nodes && !treeview.selected);
+
+		assert(treeview_build(&treeview, NULL, records, 5) == 0);
+		assert(treeview.selected == treeview.root.nodes[0]);
+		assert(treeview.root.visible == 5);
+		assert(arrlenu(treeview.root.nodes) == 2);
+
+		widget_headless_clear();
+		widget_points_set(&snapshot, 0, 10, 0, 5);
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "a\n"
+												  "├──b\n"
+												  "│  └──c\n"
+												  "└──d\n"
+												  "e\n")
+			   == -1);
+
+		/* Nodes after a deleted one move back. */
+		assert(treeview_event(&treeview, TREEVIEW_JUMP,
+				 treeview.root.nodes[0]->nodes[0])
+			   == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_DELETE) == WIDGET_REDRAW);
+		assert(treeview.selected == treeview.root.nodes[0]->nodes[0]);
+		assert(treeview.selected->index == 0);
+		widget_headless_clear();
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "a\n"
+												  "└──d\n"
+												  "e\n"
+												  "\n"
+												  "\n")
+			   == -1);
+
+		/* Building into a collapsed node leaves the rows above it. */
+		assert(treeview_event(&treeview, TREEVIEW_UP) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(treeview_build(&treeview, treeview.selected, records, 5) == 0);
+		assert(treeview.selected->visible == 6 && treeview.root.visible == 2);
+		assert(treeview.selected->nodes[2]->index == 2);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		struct widget_points snapshot = {0};
+		const struct treeview_record records[] = {
+		  {0, "a", draw_str, "alpha"},
+		  {1, "b", draw_str, "beta"},
+		  {2, "c", draw_str, "gamma"},
+		  {1, "d", draw_str, "delta"},
+		  {0, "e", draw_str, "Echo"},
+		};
+
+		assert(treeview_init(&treeview) == 0);
+		assert(treeview_build(&treeview, NULL, records, 5) == 0);
+		widget_points_set(&snapshot, 0, 10, 0, 5);
+
+		/* Parents of the matches are kept. */
+		assert(treeview_filter(&treeview, "E") == 0);
+		assert(treeview.root.visible == 4 && treeview.root.matched == 2);
+		widget_headless_clear();
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "a\n"
+												  "├──b\n"
+												  "└──d\n"
+												  "e\n"
+												  "\n")
+			   == -1);
+
+		/* Hidden nodes are skipped and can't be selected. */
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview.selected == treeview.root.nodes[0]->nodes[1]);
+		assert(treeview_event(&treeview, TREEVIEW_JUMP,
+				 treeview.root.nodes[0]->nodes[0]->nodes[0])
+			   == WIDGET_NOOP);
+
+		/* Typing moves a hidden selection to the first row. */
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview_filter(&treeview, "el") == 0);
+		assert(treeview.selected == treeview.root.nodes[0]);
+		assert(treeview.root.visible == 2);
+		assert(arrlenu(treeview.filter.ends) == 2);
+		widget_headless_clear();
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "a\n"
+												  "└──d\n"
+												  "\n"
+												  "\n"
+												  "\n")
+			   == -1);
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview.selected == treeview.root.nodes[0]->nodes[1]);
+
+		/* Erasing shows the nodes of the shorter query again. */
+		assert(treeview_filter(&treeview, "e") == 0);
+		assert(treeview.root.visible == 4);
+		assert(arrlenu(treeview.filter.ends) == 1);
+		assert(treeview_event(&treeview, TREEVIEW_UP) == WIDGET_REDRAW);
+		assert(treeview.selected == treeview.root.nodes[0]->nodes[0]);
+
+		assert(treeview_filter(&treeview, "x") == 0);
+		assert(treeview.root.visible == 0 && !treeview.selected);
+		assert(treeview_filter(&treeview, NULL) == 0);
+		assert(treeview.root.visible == 5);
+		assert(treeview.selected == treeview.root.nodes[0]);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		struct widget_points snapshot = {0};
+		struct widget_points damage = {0};
+		struct treeview_node probe = {.data = "b"};
+		const char *const inserts[] = {"c", "a", "b"};
+		const struct treeview_record records[] = {
+		  {0, "e", draw_str, NULL},
+		  {1, "z", draw_str, NULL},
+		  {1, "y", draw_str, NULL},
+		  {0, "d", draw_str, NULL},
+		};
+
+		assert(treeview_init(&treeview) == 0);
+		treeview.root.compare_cb = compare_data;
+
+		for (size_t i = 0; i < (sizeof(inserts) / sizeof(*inserts)); i++) {
+			struct treeview_node *node
+			  = treeview_pool_alloc(&treeview, (void *) inserts[i], draw_str);
+
+			assert(treeview_event(&treeview, TREEVIEW_INSERT_PARENT, node)
+				   == WIDGET_REDRAW);
+		}
+
+		/* The selection stays on the first node while it moves. */
+		assert(strcmp(treeview.selected->data, "c") == 0);
+		assert(treeview.selected->index == 2);
+		assert(treeview_node_find(&treeview.root, &probe)
+			   == treeview.root.nodes[1]);
+		probe.data = "x";
+		assert(!treeview_node_find(&treeview.root, &probe));
+
+		/* Built nodes are merged in and inherit the order. */
+		assert(treeview_build(&treeview, NULL, records, 4) == 0);
+		assert(treeview.root.nodes[4]->compare_cb == compare_data);
+		widget_headless_clear();
+		widget_points_set(&snapshot, 0, 10, 0, 7);
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "a\n"
+												  "b\n"
+												  "c\n"
+												  "d\n"
+												  "e\n"
+												  "├──y\n"
+												  "└──z\n")
+			   == -1);
+		assert(treeview.root.nodes[3]->index == 3);
+
+		/* Rows are damaged from the node inserted above the selection. */
+		assert(treeview_event_damage(&treeview, &damage, TREEVIEW_INSERT_PARENT,
+				 treeview_pool_alloc(&treeview, "aa", draw_str))
+			   == WIDGET_REDRAW);
+		assert(damage.y1 == 1 && damage.y2 == 7);
+		assert(strcmp(treeview.selected->data, "c") == 0);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		struct treeview treeview;
+		struct widget_points snapshot = {0};
+		const struct treeview_record records[] = {
+		  {0, "a", draw_str, "a"},
+		  {1, "b", draw_str, "b"},
+		  {2, "c", draw_str, "c"},
+		  {1, "d", draw_str, "d"},
+		  {0, "e", draw_str, "e"},
+		};
+		struct treeview_node *a = NULL;
+		struct treeview_node *b = NULL;
+		struct treeview_node *e = NULL;
+		struct widget_points damage = {0};
+		char *dump = NULL;
+
+		assert(treeview_init(&treeview) == 0);
+		assert(treeview_build(&treeview, NULL, records, 5) == 0);
+		a = treeview.root.nodes[0];
+		b = a->nodes[0];
+		e = treeview.root.nodes[1];
+
+		/* The filter follows the match into it's new parent. */
+		assert(treeview_filter(&treeview, "c") == 0);
+		assert(treeview.root.visible == 3);
+		assert(treeview_event(&treeview, TREEVIEW_JUMP, b) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_MOVE, e) == WIDGET_REDRAW);
+		assert(treeview.selected == b && b->parent == e && b->index == 0);
+		assert(a->is_hidden && !e->is_hidden);
+		assert(treeview.root.visible == 3);
+
+		/* Nodes can't be moved into their own subtree. */
+		assert(treeview_event(&treeview, TREEVIEW_MOVE, b->nodes[0])
+			   == WIDGET_NOOP);
+		assert(treeview_node_reparent(&treeview, &treeview.root, NULL) == -1);
+
+		assert(treeview_filter(&treeview, NULL) == 0);
+		assert(a->nodes[0]->index == 0 && a->visible == 1);
+		widget_headless_clear();
+		widget_points_set(&snapshot, 0, 10, 0, 5);
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "a\n"
+												  "└──d\n"
+												  "e\n"
+												  "└──b\n"
+												  "   └──c\n")
+			   == -1);
+
+		/* Rows above the selection change when the last child moves. */
+		assert(treeview.selected == b);
+		dump = widget_headless_dump(&snapshot);
+		assert(treeview_event_damage(&treeview, &damage, TREEVIEW_MOVE, a)
+			   == WIDGET_REDRAW);
+		widget_headless_clear();
+		treeview_redraw(&treeview, &snapshot);
+		assert(widget_headless_compare(&snapshot, "a\n"
+												  "├──d\n"
+												  "└──b\n"
+												  "   └──c\n"
+												  "e\n")
+			   == -1);
+		assert(snapshot.y1 + widget_headless_compare(&snapshot, dump)
+			   >= damage.y1);
+		WIDGETS_FREE(dump);
+
+		/* A selection moved into a collapsed node goes to it. */
+		assert(treeview_event(&treeview, TREEVIEW_JUMP, a) == WIDGET_REDRAW);
+		assert(treeview_event(&treeview, TREEVIEW_EXPAND) == WIDGET_REDRAW);
+		assert(treeview_node_reparent(&treeview, b, a) == 0);
+		assert(treeview.selected == a);
+		assert(treeview.root.visible == 2 && a->visible == 3);
+
+		treeview_finish(&treeview);
+	}
+
+	{
+		/* Deep enough to overflow the stack if walked recursively. */
+		const size_t depth = 200000;
+		struct treeview treeview;
+		struct treeview_record *records = NULL;
+		struct treeview_node *node = NULL;
+		struct treeview_node *chain = NULL;
+		struct widget_points snapshot = {0};
+
+		assert(treeview_init(&treeview) == 0);
+
+		for (size_t i = 0; i < depth; i++) {
+			struct treeview_node *next = treeview_node_alloc(NULL, draw_noop);
+
+			/* Built from the bottom so that adding stays O(1). */
+			assert(next);
+			assert(!chain || treeview_node_add_child(next, chain) == 0);
+			chain = next;
+
+			arrput(
+			  records, ((struct treeview_record) {i, NULL, draw_noop, NULL}));
+		}
+
+		treeview_node_destroy(chain);
+
+		assert(treeview_build(&treeview, NULL, records, depth) == 0);
+		arrfree(records);
+
+		for (node = treeview.root.nodes[0]; node->nodes; node = node->nodes[0])
+			;
+
+		assert(treeview_event(&treeview, TREEVIEW_JUMP, node) == WIDGET_REDRAW);
+		widget_points_set(&snapshot, 0, 10, 0, 10);
+		treeview_redraw(&treeview, &snapshot);
+		assert(treeview.start_y == (int) depth - 10);
+
+		assert(treeview_event(&treeview, TREEVIEW_DOWN) == WIDGET_REDRAW);
+		assert(treeview.selected == node);
+		assert(treeview_event(&treeview, TREEVIEW_UP) == WIDGET_REDRAW);
+		assert(treeview.selected == node->parent);
+
+		treeview_finish(&treeview);
+	}
+
+	widget_headless_finish();
+}
+#endif
+#ifdef WIDGETS_BENCH
+#include <time.h>
+
+#ifdef WIDGETS_TESTS
+#error "WIDGETS_TESTS and WIDGETS_BENCH can't be used together"
+#endif /* WIDGETS_TESTS */
+
+enum {
+	BENCH_WIDTH = 300,
+	BENCH_HEIGHT = 100,
+};
+
+/* Minimum time spent measuring each benchmark. */
+static const double bench_min_ns = 2e8;
 
-		assert(widget_str_width("Test") == 4);
-		assert(widget_str_width("😄") == 2);
-		assert(widget_str_width("Test 😄") == 7);
-		assert(widget_str_width("├──") == 3);
-		assert(widget_str_width("│") == 1);
-		assert(widget_str_width("└──") == 3);
-		assert(widget_str_width("\n") == 0);
-#define print_str(str, max_x)                                                  \
-	widget_print_str(0, 0, max_x, TB_DEFAULT, TB_DEFAULT, str)
-		const int large_testx = 100;
+static const char *bench_filter = NULL;
 
-		assert(print_str("Test", large_testx) == 4);
-		assert(print_str("Test", 4) == 4);
-		assert(print_str("Test", 3) == 3);
-		assert(print_str("Test", 0) == 0);
-		assert(print_str("Te\nst", large_testx) == 2);
-		assert(print_str("😄", large_testx) == 2);
-		assert(print_str("😄", 2) == 2);
-		assert(print_str("😄", 1) == 0);
-		assert(print_str("├──", large_testx) == 3);
-		assert(print_str("├──", 3) == 3);
-		assert(print_str("├──", 2) == 2);
-		assert(print_str("│", 1) == 1);
-		assert(print_str("│", 0) == 0);
-		assert(print_str("Test 😄", large_testx) == 7);
-		assert(print_str("Test 😄", 6) == 5);
-#undef print_str
+static double
+bench_now(void) {
+	struct timespec ts = {0};
+	clock_gettime(CLOCK_MONOTONIC, &ts);
 
-		{
-			int width = 0;
+	return ((double) ts.tv_sec * 1e9) + (double) ts.tv_nsec;
+}
 
-			assert(widget_uc_sanitize('\n', &width) == '\n');
-			assert(width == 0);
-			assert(widget_should_forcebreak(width));
-			assert(widget_should_scroll(0, 0, 0));
+/* Runs op until enough time has passed and prints the results in the format of
+ * Go's benchmarks so that existing tools can compare them. */
+static void
+bench_run(const char *name, void (*op)(void *ctx), void *ctx) {
+	if (bench_filter && !strstr(name, bench_filter)) {
+		return;
+	}
 
-			assert(widget_uc_sanitize('\t', &width) == ' ');
-			assert(width == 1);
+	size_t iterations = 1;
 
-			assert(widget_uc_sanitize(L'😄', &width) == L'😄');
-			assert(width == 2);
+	for (;;) {
+		size_t allocs = bench_allocs;
+		double start = bench_now();
+
+		for (size_t i = 0; i < iterations; i++) {
+			op(ctx);
 		}
 
-		assert(!widget_should_scroll(tb_width() - 1, 1, tb_width()));
-		assert(widget_should_scroll(tb_width(), 1, tb_width()));
+		double elapsed = bench_now() - start;
 
-		assert(widget_pad_center(40, 80) == 20);
-		assert(widget_pad_center(26, 85) == 30);
-		assert(widget_pad_center(50, 10) == 0);
+		if (elapsed >= bench_min_ns || iterations >= ((size_t) 1 << 30)) {
+			printf("Benchmark%s\t%zu\t%.1f ns/op\t%.2f allocs/op\n", name,
+			  iterations, elapsed / (double) iterations,
+			  (double) (bench_allocs - allocs) / (double) iterations);
+			fflush(stdout);
+			return;
+		}
+
+		/* Aim slightly past the minimum time to avoid another round. */
+		double per_op = elapsed / (double) iterations;
+		size_t next = per_op > 0 ? (size_t) (bench_min_ns * 1.2 / per_op) : 0;
+
+		iterations = next > iterations * 100 ? iterations * 100
+			: next > iterations				 ? next
+											 : iterations * 2;
 	}
+}
+
+/* Corpora of roughly a full row each. */
+static const char bench_ascii[]
+  = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+	"tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+	"veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+	"commodo consequat. Duis aute irure dolor in reprehenderit in voluptate.";
+static const char bench_cjk[]
+  = "春眠不覚暁処処聞啼鳥夜来風雨声花落知多少床前明月光疑是地上霜挙頭"
+	"望山月低頭思故郷白日依山尽黄河入海流欲窮千里目更上一層楼千山鳥飛"
+	"絶万径人踪滅孤舟蓑笠翁独釣寒江雪国破山河在城春草木深感時花濺涙恨"
+	"別鳥驚心烽火連三月家書抵万金白頭掻更短渾欲不勝簪";
+static const char bench_emoji[]
+  = "😀😃😄😁😆😅😂🤣😊😇🙂🙃😉😌😍🥰😘😗😙😚😋😛😝😜"
+	"🤪🤨🧐🤓😎🥸🤩🥳😏😒😞😔😟😕🙁😣😖😫😩🥺😢😭😤😠"
+	"😡🤬🤯😳🥵🥶😱😨😰😥😓🤗🤔🤭🤫🤥😶😐😑😬🙄😯😦😧"
+	"😮😲🥱😴🤤😪😵🤐🥴🤢🤮🤧😷🤒🤕🤑🤠😈👿👹👺🤡💩👻"
+	"💀👽👾🤖🎃😺😸😹😻😼😽🙀😿😾👋🤚🖐✋🖖👌🤌🤏✌🤞"
+	"🤟🤘🤙👈👉👆🖕👇☝👍👎✊👊🤛🤜👏🙌👐🤲🤝🙏";
+
+static void
+bench_str_width(void *ctx) {
+	widget_str_width(ctx);
+}
+
+static void
+bench_print_str(void *ctx) {
+	widget_print_str(0, 0, BENCH_WIDTH, TB_DEFAULT, TB_DEFAULT, ctx);
+}
+
+static void
+bench_text_print(void *ctx) {
+	widget_text_print(ctx, 0, 0, BENCH_WIDTH, TB_DEFAULT, TB_DEFAULT);
+}
+
+static void
+bench_border_redraw(void *ctx) {
+	border_redraw(ctx, TB_DEFAULT, TB_DEFAULT);
+}
+
+struct bench_input {
+	struct input input;
+	struct widget_points points;
+	enum input_event event;
+};
 
+static void
+bench_input_redraw(void *ctx) {
+	struct bench_input *bench = ctx;
+	int rows = 0;
+
+	input_redraw(&bench->input, &bench->points, &rows, false);
+}
+
+/* Moves the cursor one step and back. */
+static void
+bench_input_move(void *ctx) {
+	struct bench_input *bench = ctx;
+
+	input_handle_event(&bench->input, bench->event);
+	input_handle_event(&bench->input,
+	  bench->event == INPUT_LEFT ? INPUT_RIGHT
+	  : bench->event == INPUT_UP ? INPUT_DOWN
+								 : INPUT_RIGHT_WORD);
+}
+
+/* Inserts a character and deletes it again. */
+static void
+bench_input_edit(void *ctx) {
+	struct bench_input *bench = ctx;
+
+	input_handle_event(&bench->input, INPUT_ADD, 'x');
+	input_handle_event(&bench->input, INPUT_DELETE);
+}
+
+static void
+bench_input_buf(void *ctx) {
+	struct bench_input *bench = ctx;
+
+	WIDGETS_FREE(input_buf(&bench->input));
+}
+
+static void
+bench_input_buf_into(void *ctx) {
+	static char dst[1 << 20];
+	struct bench_input *bench = ctx;
+
+	input_buf_into(&bench->input, dst, sizeof(dst));
+}
+
+/* Pastes a row of text into an empty input. */
+static void
+bench_input_paste(void *ctx) {
+	struct bench_input *bench = ctx;
+
+	input_handle_event(
+	  &bench->input, INPUT_ADD_STR, bench_ascii, sizeof(bench_ascii) - 1);
+	input_handle_event(&bench->input, INPUT_CLEAR);
+}
+
+static void
+bench_inputs(void) {
+	const size_t lens[] = {BUF_MAX, 200000};
+	char name[128];
 	struct widget_points points = {0};
-	widget_points_set(&points, 0, 80, 0, 24);
 
-	{
-		int x = 78;
-		int y = 0;
+	widget_points_set(&points, 0, BENCH_WIDTH, 0, BENCH_HEIGHT);
 
-		assert(!widget_advance_xy_if_scroll(&x, &y, &points, 2));
-		assert(y == 0);
-		assert(x == 78);
+	for (size_t l = 0; l < (sizeof(lens) / sizeof(*lens)); l++) {
+		for (int horizontal = 0; horizontal < 2; horizontal++) {
+			char mode[64];
+			struct bench_input bench = {.points = points};
 
-		x = 80;
+			snprintf(mode, sizeof(mode), "%s/len=%zu",
+			  horizontal ? "scroll" : "wrap", lens[l]);
+			input_init(&bench.input, TB_DEFAULT, horizontal);
+			bench.input.max_len = 0;
 
-		points.x1 = 2;
+			/* Fill with words and the occasional newline. */
+			for (size_t i = 0; i < lens[l]; i++) {
+				uint32_t ch
+				  = (uint32_t) bench_ascii[i % (sizeof(bench_ascii) - 1)];
+				input_handle_event(
+				  &bench.input, INPUT_ADD, (i % 500) == 499 ? '\n' : ch);
+			}
 
-		assert(widget_advance_xy_if_scroll(&x, &y, &points, 1));
-		assert(y == 1);
-		assert(x == 2);
+			snprintf(name, sizeof(name), "InputRedraw/%s/end", mode);
+			bench_run(name, bench_input_redraw, &bench);
 
-		points.x1 = 0;
-	}
+			bench.input.cur_buf = lens[l] / 2;
+			snprintf(name, sizeof(name), "InputRedraw/%s/middle", mode);
+			bench_run(name, bench_input_redraw, &bench);
 
-	{
-		struct input input;
-		int rows = 0;
+			bench.event = INPUT_LEFT;
+			snprintf(name, sizeof(name), "InputLeft/%s", mode);
+			bench_run(name, bench_input_move, &bench);
 
-		assert(input_init(&input, TB_DEFAULT, false) == 0);
-		input_redraw(&input, &points, &rows, false);
-		assert(rows == 1);
+			bench.event = INPUT_LEFT_WORD;
+			snprintf(name, sizeof(name), "InputLeftWord/%s", mode);
+			bench_run(name, bench_input_move, &bench);
 
-		input.scroll_horizontal = true;
-		input_redraw(&input, &points, &rows, false);
-		assert(rows == 1);
+			bench.event = INPUT_UP;
+			snprintf(name, sizeof(name), "InputUp/%s", mode);
+			bench_run(name, bench_input_move, &bench);
 
-		input.scroll_horizontal = false;
+			snprintf(name, sizeof(name), "InputEdit/%s/middle", mode);
+			bench_run(name, bench_input_edit, &bench);
 
-		for (size_t i = 0; i < BUF_MAX; i++) {
-			assert(input_handle_event(&input, INPUT_ADD, ' ') == WIDGET_REDRAW);
+			snprintf(name, sizeof(name), "InputBuf/%s", mode);
+			bench_run(name, bench_input_buf, &bench);
+
+			snprintf(name, sizeof(name), "InputBufInto/%s", mode);
+			bench_run(name, bench_input_buf_into, &bench);
+
+			input_finish(&bench.input);
 		}
+	}
 
-		assert(input_handle_event(&input, INPUT_ADD, ' ') == WIDGET_NOOP);
-		input_redraw(&input, &points, &rows, false);
-		assert(rows == 24);
+	struct bench_input bench = {.points = points};
 
-		input.scroll_horizontal = true;
-		input_redraw(&input, &points, &rows, false);
-		assert(rows == 1);
-		input.scroll_horizontal = false;
+	input_init(&bench.input, TB_DEFAULT, false);
+	bench_run("InputPaste/ascii", bench_input_paste, &bench);
+	input_finish(&bench.input);
+}
 
-		char *buf = input_buf(&input);
-		assert(strlen(buf) == 2000);
-		free(buf);
-		buf = NULL;
+struct bench_tree {
+	struct treeview treeview;
+	struct widget_points points;
+	struct treeview_node **nodes;
+	size_t len;
+	size_t fanout;
+	bool pool;	 /* Whether nodes are allocated from the treeview's pool. */
+	size_t next; /* Index of the next node to jump to. */
+	/* The same tree in pre-order, built with treeview_build() if set. */
+	struct treeview_record *records;
+	char *keys; /* Index of each node as the key, BENCH_KEY bytes each. */
+};
 
-		input_handle_event(&input, INPUT_CLEAR);
-		assert(input_buf(&input) == NULL);
+enum { BENCH_KEY = 16 };
 
-		input_finish(&input);
-		assert(input_init(&input, TB_DEFAULT, false) == 0);
+static void
+bench_draw(void *data, struct widget_points *points, bool is_selected) {
+	widget_print_str(points->x1, points->y1, points->x2, TB_DEFAULT,
+	  is_selected ? TB_BOLD : TB_DEFAULT, data);
+}
 
-		char *buf_test = "Test";
+/* Builds a tree where every node has fanout children, breadth first. */
+static void
+bench_tree_init(
+  struct bench_tree *bench, size_t len, size_t fanout, bool pool) {
+	*bench = (struct bench_tree) {.len = len, .fanout = fanout, .pool = pool};
 
-		/* Empty. */
-		for (enum input_event event = INPUT_DELETE; event < INPUT_ADD;
-			 event++) {
-			assert(input_handle_event(&input, event) == WIDGET_NOOP);
+	treeview_init(&bench->treeview);
+	widget_points_set(&bench->points, 0, BENCH_WIDTH, 0, BENCH_HEIGHT);
+	arrsetlen(bench->nodes, len);
+
+	for (size_t i = 0; i < len; i++) {
+		bench->nodes[i]
+		  = pool ? treeview_pool_alloc(
+					 &bench->treeview, (void *) "Lorem ipsum", bench_draw)
+				 : treeview_node_alloc((void *) "Lorem ipsum", bench_draw);
+	}
+
+	/* Linked from the bottom so that the rows of deep chains aren't updated
+	 * along all of their parents for every node. Children of i are the next
+	 * fanout nodes after (i + 1) * fanout. */
+	for (size_t i = len; i > 0; i--) {
+		size_t first = min_size(i * fanout, len);
+		size_t end = min_size(first + fanout, len);
+
+		for (size_t j = first; j < end; j++) {
+			treeview_node_add_child(bench->nodes[i - 1], bench->nodes[j]);
 		}
+	}
 
-		for (size_t i = 0, len = strlen(buf_test); i < len; i++) {
-			assert(input_handle_event(&input, INPUT_ADD, buf_test[i])
-				   == WIDGET_REDRAW);
+	for (size_t i = 0; i < min_size(fanout, len); i++) {
+		treeview_node_add_child(&bench->treeview.root, bench->nodes[i]);
+	}
+
+	treeview_event(&bench->treeview, TREEVIEW_JUMP, bench->nodes[0]);
+}
+
+static void
+bench_tree_finish(struct bench_tree *bench) {
+	treeview_finish(&bench->treeview);
+	arrfree(bench->nodes);
+	arrfree(bench->keys);
+}
+
+/* Fills records with the tree of bench_tree_init() in pre-order. */
+static void
+bench_tree_records(struct bench_tree *bench) {
+	size_t *stack = NULL; /* Pairs of node indices and depths. */
+
+	arrsetlen(bench->records, 0);
+
+	for (size_t i = min_size(bench->fanout, bench->len); i > 0; i--) {
+		arrput(stack, i - 1);
+		arrput(stack, 0);
+	}
+
+	while ((arrlenu(stack)) > 0) {
+		size_t depth = arrpop(stack);
+		size_t i = arrpop(stack);
+
+		arrput(bench->records, ((struct treeview_record) {depth,
+								 (void *) "Lorem ipsum", bench_draw, NULL}));
+
+		size_t first = min_size((i + 1) * bench->fanout, bench->len);
+		size_t end = min_size(first + bench->fanout, bench->len);
+
+		for (size_t j = end; j > first; j--) {
+			arrput(stack, j - 1);
+			arrput(stack, depth + 1);
 		}
+	}
 
-		assert(input.cur_buf == 4);
+	arrfree(stack);
+}
 
-		assert(arrlenu(input.buf) == strlen(buf_test));
-		char *buf_input = input_buf(&input);
-		assert(strcmp(buf_test, buf_input) == 0);
-		free(buf_input);
+/* Builds a whole tree like the one in ctx and frees it again. */
+static void
+bench_treeview_build(void *ctx) {
+	const struct bench_tree *shape = ctx;
+	struct bench_tree bench;
+
+	if (shape->records) {
+		treeview_init(&bench.treeview);
+		treeview_build(&bench.treeview, NULL, shape->records, shape->len);
+		treeview_finish(&bench.treeview);
+		return;
+	}
 
-		assert(input_handle_event(&input, INPUT_LEFT) == WIDGET_REDRAW);
-		assert(input.cur_buf == 3);
-		assert(input_handle_event(&input, INPUT_LEFT_WORD) == WIDGET_REDRAW);
-		assert(input.cur_buf == 0);
+	bench_tree_init(&bench, shape->len, shape->fanout, shape->pool);
+	bench_tree_finish(&bench);
+}
 
-		assert(input_handle_event(&input, INPUT_RIGHT) == WIDGET_REDRAW);
-		assert(input.cur_buf == 1);
-		assert(input_handle_event(&input, INPUT_RIGHT_WORD) == WIDGET_REDRAW);
-		assert(input.cur_buf == 4);
+static void
+bench_treeview_redraw(void *ctx) {
+	struct bench_tree *bench = ctx;
 
-		assert(input_handle_event(&input, INPUT_LEFT) == WIDGET_REDRAW);
-		assert(input.cur_buf == 3);
+	treeview_redraw(&bench->treeview, &bench->points);
+}
 
-		assert(input_handle_event(&input, INPUT_ADD, 'i') == WIDGET_REDRAW);
-		assert(input.cur_buf == 4);
+/* Walks down the whole tree, starting over after the last node. */
+static void
+bench_treeview_down(void *ctx) {
+	struct bench_tree *bench = ctx;
+	struct treeview_node *selected = bench->treeview.selected;
 
-		assert(input_handle_event(&input, INPUT_LEFT) == WIDGET_REDRAW);
-		assert(input.cur_buf == 3);
+	treeview_event(&bench->treeview, TREEVIEW_DOWN);
 
-		assert(input_handle_event(&input, INPUT_RIGHT_WORD) == WIDGET_REDRAW);
-		assert(input.cur_buf == 5);
+	if (bench->treeview.selected == selected) {
+		treeview_event(&bench->treeview, TREEVIEW_JUMP, bench->nodes[0]);
+	}
+}
 
-		assert(input_handle_event(&input, INPUT_DELETE) == WIDGET_REDRAW);
-		buf_input = input_buf(&input);
-		assert(strcmp("Tesi", buf_input) == 0);
-		free(buf_input);
+static void
+bench_treeview_jump(void *ctx) {
+	struct bench_tree *bench = ctx;
 
-		assert(input_handle_event(&input, INPUT_DELETE_WORD) == WIDGET_REDRAW);
-		assert(input_buf(&input) == NULL);
+	/* Spread the jumps over the whole tree. */
+	bench->next = (bench->next + 7919) % bench->len;
+	treeview_event(
+	  &bench->treeview, TREEVIEW_JUMP, bench->nodes[bench->next]);
+}
 
-		input_finish(&input);
+static void
+bench_treeview_expand(void *ctx) {
+	struct bench_tree *bench = ctx;
+
+	treeview_event(&bench->treeview, TREEVIEW_EXPAND);
+	treeview_event(&bench->treeview, TREEVIEW_EXPAND);
+}
+
+/* Types a query and erases it again, then clears the filter. */
+static void
+bench_treeview_filter(void *ctx) {
+	struct bench_tree *bench = ctx;
+	const char *queries[] = {"1", "12", "123", "1234", "123", "12", "1", NULL};
+
+	for (size_t i = 0; i < (sizeof(queries) / sizeof(*queries)); i++) {
+		treeview_filter(&bench->treeview, queries[i]);
 	}
+}
+
+/* Moves the second node to the top level and back under the first one. */
+static void
+bench_treeview_move(void *ctx) {
+	struct bench_tree *bench = ctx;
 
-	assert(tb_shutdown() == TB_OK);
+	treeview_node_reparent(&bench->treeview, bench->nodes[1], NULL);
+	treeview_node_reparent(
+	  &bench->treeview, bench->nodes[1], bench->nodes[0]);
 }
-#endif
+
+static void
+bench_treeviews(void) {
+	const size_t lens[] = {1000, 10000, 100000, 1000000};
+	/* 1 for a single chain and 0 for a flat tree. */
+	const size_t fanouts[] = {1, 2, 10, 0};
+	char name[128];
+
+	for (size_t i = 0; i < (sizeof(lens) / sizeof(*lens)); i++) {
+		for (size_t j = 0; j < (sizeof(fanouts) / sizeof(*fanouts)); j++) {
+			struct bench_tree bench;
+			size_t fanout = fanouts[j] ? fanouts[j] : lens[i];
+			char shape[32];
+
+			snprintf(shape, sizeof(shape), "nodes=%zu/fanout=%zu", lens[i],
+			  fanout);
+
+			/* Building the larger trees takes a while, skip them if no
+			 * benchmark would run. */
+			if (bench_filter && !strstr(shape, bench_filter)
+				&& !strstr("TreeviewBuild TreeviewRedraw TreeviewDown "
+						   "TreeviewJump TreeviewExpand TreeviewFilter "
+						   "TreeviewMove",
+				  bench_filter)) {
+				continue;
+			}
+
+			for (int pool = 0; pool < 2; pool++) {
+				bench = (struct bench_tree) {
+				  .len = lens[i], .fanout = fanout, .pool = pool};
+				snprintf(name, sizeof(name), "TreeviewBuild/%s/%s", shape,
+				  pool ? "pool" : "malloc");
+				bench_run(name, bench_treeview_build, &bench);
+			}
+
+			bench_tree_records(&bench);
+			snprintf(name, sizeof(name), "TreeviewBuild/%s/bulk", shape);
+			bench_run(name, bench_treeview_build, &bench);
+			arrfree(bench.records);
+
+			bench_tree_init(&bench, lens[i], fanout, false);
+
+			snprintf(name, sizeof(name), "TreeviewRedraw/%s/top", shape);
+			bench_run(name, bench_treeview_redraw, &bench);
+
+			treeview_event(
+			  &bench.treeview, TREEVIEW_JUMP, bench.nodes[lens[i] - 1]);
+			snprintf(name, sizeof(name), "TreeviewRedraw/%s/bottom", shape);
+			bench_run(name, bench_treeview_redraw, &bench);
+
+			treeview_event(&bench.treeview, TREEVIEW_JUMP, bench.nodes[0]);
+			snprintf(name, sizeof(name), "TreeviewDown/%s", shape);
+			bench_run(name, bench_treeview_down, &bench);
+
+			snprintf(name, sizeof(name), "TreeviewJump/%s", shape);
+			bench_run(name, bench_treeview_jump, &bench);
+
+			treeview_event(&bench.treeview, TREEVIEW_JUMP, bench.nodes[0]);
+			snprintf(name, sizeof(name), "TreeviewExpand/%s", shape);
+			bench_run(name, bench_treeview_expand, &bench);
+
+			arrsetlen(bench.keys, lens[i] * BENCH_KEY);
+
+			for (size_t k = 0; k < lens[i]; k++) {
+				snprintf(&bench.keys[k * BENCH_KEY], BENCH_KEY, "%u",
+				  (unsigned) k);
+				bench.nodes[k]->key = &bench.keys[k * BENCH_KEY];
+			}
+
+			snprintf(name, sizeof(name), "TreeviewFilter/%s", shape);
+			bench_run(name, bench_treeview_filter, &bench);
+
+			snprintf(name, sizeof(name), "TreeviewMove/%s", shape);
+			bench_run(name, bench_treeview_move, &bench);
+
+			bench_tree_finish(&bench);
+		}
+	}
+}
+
+/* Usage: ./bench [filter], only benchmarks containing filter are run. */
+int
+main(int argc, char **argv) {
+	bench_filter = argc > 1 ? argv[1] : NULL;
+
+	if ((widget_headless_init(BENCH_WIDTH, BENCH_HEIGHT)) != 0) {
+		return EXIT_FAILURE;
+	}
+
+	const char *corpora[][2] = {
+	  {"ascii", bench_ascii},
+	  {  "cjk",	bench_cjk},
+	  {"emoji", bench_emoji},
+	};
+	char name[128];
+
+	for (size_t i = 0; i < (sizeof(corpora) / sizeof(*corpora)); i++) {
+		struct widget_text text = {0};
+
+		widget_text_init(&text, corpora[i][1]);
+
+		snprintf(name, sizeof(name), "StrWidth/%s", corpora[i][0]);
+		bench_run(name, bench_str_width, (void *) corpora[i][1]);
+		snprintf(name, sizeof(name), "PrintStr/%s", corpora[i][0]);
+		bench_run(name, bench_print_str, (void *) corpora[i][1]);
+		snprintf(name, sizeof(name), "TextPrint/%s", corpora[i][0]);
+		bench_run(name, bench_text_print, &text);
+
+		widget_text_finish(&text);
+	}
+
+	struct widget_points points = {0};
+
+	widget_points_set(&points, 0, BENCH_WIDTH, 0, BENCH_HEIGHT);
+	bench_run("BorderRedraw/300x100", bench_border_redraw, &points);
+	widget_points_set(&points, 0, 20, 0, 5);
+	bench_run("BorderRedraw/20x5", bench_border_redraw, &points);
+
+	bench_inputs();
+	bench_treeviews();
+
+	widget_headless_finish();
+}
+#endif /* WIDGETS_BENCH */
 #endif /* WIDGETS_IMPL */